@@ -0,0 +1,128 @@
+#include "ChangeSet.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+#include <cctype>
+#include <cstring>
+
+ChangeSet::ChangeSet() {
+	errorLine = 0;
+}
+
+bool ChangeSet::load(const string& fileName) {
+	MappedFile input;
+	if (!input.open(fileName)) {
+		return false;
+	}
+	const char* position = input.data();
+	const char* end = position + input.size();
+	int line = 1;
+	while (position < end) {
+		const char* lineEnd = (const char*)memchr(position, '\n', end - position);
+		if (lineEnd == 0) {
+			lineEnd = end;
+		}
+		if (!parseLine(StringView(position, lineEnd - position))) {
+			errorLine = line;
+			return false;
+		}
+		position = lineEnd + 1;
+		++line;
+	}
+	return true;
+}
+
+bool ChangeSet::parseLine(StringView text) {
+	const char* position = text.data();
+	const char* end = position + text.size();
+	while (position < end && isspace((unsigned char)*position)) {
+		++position;
+	}
+	while (end > position && isspace((unsigned char)end[-1])) {
+		--end;
+	}
+	if (position == end || *position == '#') {
+		return true;
+	}
+	char sign = *position++;
+	if (sign != '+' && sign != '-') {
+		return false;
+	}
+	while (position < end && isspace((unsigned char)*position)) {
+		++position;
+	}
+	const char* nameStart = position;
+	if (position == end || !isalpha((unsigned char)*position)) {
+		return false;
+	}
+	while (position < end && isalnum((unsigned char)*position)) {
+		++position;
+	}
+	string name(nameStart, position);
+	while (position < end && isspace((unsigned char)*position)) {
+		++position;
+	}
+	if (position == end || *position++ != '(') {
+		return false;
+	}
+	Tuple t;
+	while (true) {
+		while (position < end && isspace((unsigned char)*position)) {
+			++position;
+		}
+		if (position == end || *position != '\'') {
+			return false;
+		}
+		const char* close = (const char*)memchr(position + 1, '\'', end - position - 1);
+		if (close == 0) {
+			return false;
+		}
+		t.push_back(SymbolTable::intern(string(position, close + 1)));
+		position = close + 1;
+		while (position < end && isspace((unsigned char)*position)) {
+			++position;
+		}
+		if (position < end && *position == ',') {
+			++position;
+			continue;
+		}
+		break;
+	}
+	if (position == end || *position++ != ')') {
+		return false;
+	}
+	while (position < end && isspace((unsigned char)*position)) {
+		++position;
+	}
+	if (position == end || *position++ != '.' || position != end) {
+		return false;
+	}
+	Relation& changed = sign == '+' ? inserts[name] : deletes[name];
+	if (changed.size() > 0 && changed.getArity() != (int)t.size()) {
+		return false;
+	}
+	changed.setName(name);
+	changed.setTuples(t);
+	return true;
+}
+
+map<string, Relation>& ChangeSet::getInserts() {
+	return inserts;
+}
+
+map<string, Relation>& ChangeSet::getDeletes() {
+	return deletes;
+}
+
+int ChangeSet::getErrorLine() {
+	return errorLine;
+}
+
+bool ChangeSet::empty() {
+	return inserts.empty() && deletes.empty();
+}
+
+void ChangeSet::clear() {
+	inserts.clear();
+	deletes.clear();
+	errorLine = 0;
+}
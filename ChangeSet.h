@@ -0,0 +1,23 @@
+#pragma once
+#include "Relation.h"
+#include "StringView.h"
+#include <string>
+#include <map>
+using namespace std;
+
+class ChangeSet {
+
+	public:
+		ChangeSet();
+		bool load(const string&);
+		bool parseLine(StringView);
+		map<string, Relation>& getInserts();
+		map<string, Relation>& getDeletes();
+		int getErrorLine();
+		bool empty();
+		void clear();
+	private:
+		map<string, Relation> inserts;
+		map<string, Relation> deletes;
+		int errorLine;
+};
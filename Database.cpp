@@ -6,20 +6,42 @@ Database::Database() {
 }
 
 
-map<string,Relation> Database::getRelations() {
+map<string,Relation>& Database::getRelations() {
     return relations;
 }
 
+Relation& Database::getRelation(const string& name) {
+	return relations.at(name);
+}
+
 void Database::initializeRelations(pair<string, Relation>& newPair) {
 	relations[newPair.first] = newPair.second;
 }
 
 void Database::setRelations(pair<string, Relation>& newPair) {
-	if (relations[newPair.first].getTuples() != newPair.second.getTuples()) {
+	if (!relations[newPair.first].sameTuples(newPair.second)) {
 		relations[newPair.first] = newPair.second;
 		if(newPair.second.getScheme().size() > 0)
-		tupleCount += newPair.second.getTuples().size();
+		tupleCount += newPair.second.size();
+	}
+}
+
+int Database::addTuples(const string& name, Relation& newTuples) {
+	Relation& relation = relations.at(name);
+	int added = relation.addTuples(newTuples);
+	if (added > 0 && relation.getScheme().size() > 0) {
+		tupleCount += added;
+	}
+	return added;
+}
+
+int Database::removeTuples(const string& name, Relation& oldTuples) {
+	Relation& relation = relations.at(name);
+	int removed = relation.removeTuples(oldTuples);
+	if (removed > 0 && relation.getScheme().size() > 0) {
+		tupleCount -= removed;
 	}
+	return removed;
 }
 
 void Database::removeRelation(string& name) {
@@ -31,16 +53,26 @@ void Database::setTuple(string& name, Tuple& tuple) {
 	tupleCount++;
 }
 
+void Database::loadFacts(const string& name, Relation& facts) {
+	Relation& relation = relations[name];
+	int before = relation.size();
+	relation.adoptTuples(facts);
+	tupleCount += relation.size() - before;
+}
+
 int Database::getTupleCount() {
 	return tupleCount;
 }
 
 string Database::toString() {
-	string database =  "";
+	OutputWriter database;
+	write(database);
+	return database.str();
+}
+
+void Database::write(OutputWriter& output) {
 	for (map<string, Relation>::iterator it = relations.begin(); it != relations.end(); ++it) {
-		pair<string, Relation> p1 = *it;
-		database += p1.second.toString(true);
-		database += "\n";
+		it->second.write(output, true);
+		output << '\n';
 	}
-	return database;
 }
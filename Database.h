@@ -3,19 +3,25 @@
 #include "Scheme.h"
 #include "DatalogParser.h"
 #include <map>
+#include <atomic>
 using namespace std;
 
 class Database {
 	public:
         Database();
-		map<string, Relation> getRelations();
+		map<string, Relation>& getRelations();
+		Relation& getRelation(const string&);
 		void setRelations(pair<string, Relation>&);
+		int addTuples(const string&, Relation&);
+		int removeTuples(const string&, Relation&);
 		void setTuple(string&, Tuple&);
+		void loadFacts(const string&, Relation&);
 		int getTupleCount();
 		void initializeRelations(pair<string, Relation>&);
 		string toString();
+		void write(OutputWriter&);
 		void removeRelation(string&);
 	private:
 		map<string,Relation> relations;
-		int tupleCount;
+		atomic<int> tupleCount;
 };
@@ -1,19 +1,29 @@
 #include "DatalogParser.h"
+#include "SymbolTable.h"
 #include <vector>
 #include <fstream>
 using namespace std;
 
-DatalogParser::DatalogParser(vector<Token>& tokens){
-	this->tokens = tokens;
-	tokenIndexer = 0;
+DatalogParser::DatalogParser(Scanner& scanner) : scanner(scanner) {
+	factRelation = 0;
+	factCount = 0;
+	current = scanner.next();
+}
+
+void DatalogParser::advance() {
+	current = scanner.next();
 }
 
 vector<Predicate> DatalogParser::getSchemesList(){
 	return schemesList;
 }
 
-vector<Predicate> DatalogParser::getFactsList(){
-	return factsList;
+map<string, Relation>& DatalogParser::getFacts(){
+	return facts;
+}
+
+int DatalogParser::getFactCount(){
+	return factCount;
 }
 
 vector<Rule> DatalogParser::getRulesList(){
@@ -32,16 +42,22 @@ void DatalogParser::parseFile(string fileName){
 		schemeList();
 		match("Facts");
 		match(":");
-		if (tokens[tokenIndexer].getValue() != "Rules") {
+		if (current.getText() != StringView("Rules")) {
 			parseFact();
 			factList();
 		}
 		match("Rules");
 		match(":");
-		if (tokens[tokenIndexer].getValue() != "Queries") {
+		if (current.getText() != StringView("Queries")) {
 			parseRule();
 			ruleList();
 		}
+		for (unsigned int i = 0; i < rulesList.size(); ++i) {
+			map<string, Relation>::iterator it = facts.find(rulesList[i].getPred().getID());
+			if (it != facts.end()) {
+				it->second.setLayout(TupleStore::ROW);
+			}
+		}
 		match("Queries");
 		match(":");
 		parseQuery();
@@ -57,16 +73,24 @@ void DatalogParser::parseFile(string fileName){
 }
 
 void DatalogParser::writeOutput(string& fileName) {
-	ofstream output;
+	OutputWriter output;
 	output.open(fileName);
 	output << "Success!" << endl;
 	output << "Schemes" << '(' << to_string(schemesList.size()) << "):" << endl;
     for (unsigned int i = 0; i < schemesList.size(); i++) {
 		output << "  " << schemesList[i].toString() << endl;
 	}
-	output << "Facts(" + to_string(factsList.size()) + "):" << endl;
-    for (unsigned int i = 0; i < factsList.size(); i++) {
-		output << "  " << factsList[i].toString() << endl;
+	output << "Facts(" + to_string(factCount) + "):" << endl;
+	Tuple t;
+	for (map<string, Relation>::iterator it = facts.begin(); it != facts.end(); ++it) {
+		for (int row = 0; row < it->second.size(); ++row) {
+			it->second.readRow(row, t);
+			output << "  " << it->first << '(';
+			for (size_t i = 0; i < t.size(); ++i) {
+				output << SymbolTable::lookup(t[i]) << (i + 1 < t.size() ? "," : "");
+			}
+			output << ')' << endl;
+		}
 	}
 	output << "Rules(" + to_string(rulesList.size()) + "):" << endl;
     for (unsigned int i = 0; i < rulesList.size(); i++) {
@@ -77,7 +101,11 @@ void DatalogParser::writeOutput(string& fileName) {
 		output << "  " << queriesList[i].toString() << endl;
 	}
 	output << "Domain(" + to_string(domains.size()) + "):" << endl;
-	for (set<string>::iterator i = domains.begin(); i != domains.end(); i++) {
+	set<string> domainNames;
+	for (set<int>::iterator i = domains.begin(); i != domains.end(); i++) {
+		domainNames.insert(SymbolTable::lookup(*i));
+	}
+	for (set<string>::iterator i = domainNames.begin(); i != domainNames.end(); i++) {
 		output << "  " << *i << endl;
 	}
 }
@@ -89,11 +117,51 @@ void DatalogParser::parseScheme(){
 }
 	
 void DatalogParser::parseFact(){
-	Predicate pred;
-	parsePredicate(pred);
-	factsList.push_back(pred);
+	if (current.getType() != ID_ENUM_VALUE) {
+		throw current;
+	}
+	StringView name = current.getText();
+	if (factRelation == 0 || name != StringView(factName)) {
+		factName = name.toString();
+		factRelation = &facts[factName];
+		if (factRelation->size() == 0) {
+			factRelation->setLayout(TupleStore::COLUMN);
+		}
+	}
+	advance();
+	match("(");
+	factTuple.clear();
+	parseFactValue();
+	while (current.getType() == Token::COMMA) {
+		advance();
+		parseFactValue();
+	}
+	match(")");
+	factRelation->setTuples(factTuple);
+	++factCount;
 	match(".");
 }
+
+void DatalogParser::parseFactValue() {
+	if (current.getType() == STRING_ENUM_VALUE) {
+		int symbol = internText();
+		domains.insert(symbol);
+		factTuple.push_back(symbol);
+	}
+	else if (current.getType() == ID_ENUM_VALUE) {
+		factTuple.push_back(internText());
+	}
+	else {
+		throw current;
+	}
+	advance();
+}
+
+int DatalogParser::internText() {
+	StringView value = current.getText();
+	text.assign(value.data(), value.size());
+	return SymbolTable::intern(text);
+}
 	
 void DatalogParser::parseRule(){
 	Predicate pred1;
@@ -116,91 +184,97 @@ void DatalogParser::parseQuery(){
 	match("?");
 }
 
+bool DatalogParser::parseQueryText(Predicate& pred) {
+	try {
+		parsePredicate(pred);
+		match("?");
+		match("");
+	} catch(Token t) {
+		return false;
+	}
+	return true;
+}
+
 void DatalogParser::parsePredicate(Predicate &pred){
-	if(tokens[tokenIndexer].getType() == ID_ENUM_VALUE) {
-		pred.setID(tokens[tokenIndexer].getValue());
-		tokenIndexer++;
+	if(current.getType() == ID_ENUM_VALUE) {
+		pred.setID(current.getValue());
+		advance();
 		match("(");
 		parseParameter(pred);
 		parameterList(pred);
 		match(")");
 	}
 	else {
-		throw tokens[tokenIndexer];
+		throw current;
 	}
 }
 
 void DatalogParser::parseParameter(Predicate &pred) {
-	if(tokens[tokenIndexer].getType() == ID_ENUM_VALUE) {
+	if(current.getType() == ID_ENUM_VALUE) {
 		Parameter param;
 		param.setisID(true);
-		param.setValue(tokens[tokenIndexer].getValue());
+		param.setValue(current.getValue());
 		pred.setParams(param);
-		tokenIndexer++;
+		advance();
 	}
-	else if(tokens[tokenIndexer].getType() == STRING_ENUM_VALUE) {
+	else if(current.getType() == STRING_ENUM_VALUE) {
 		Parameter param;
 		param.setisID(false);
-		param.setValue(tokens[tokenIndexer].getValue());
+		param.setValue(current.getValue());
+		param.setSymbol(internText());
 		pred.setParams(param);
-		domains.insert(tokens[tokenIndexer].getValue());
-		tokenIndexer++;
+		domains.insert(param.getSymbol());
+		advance();
 	}
 	else {
-		throw tokens[tokenIndexer];
+		throw current;
 	}
 }
 	
 void DatalogParser::schemeList(){
-	if (tokens[tokenIndexer].getType() == ID_ENUM_VALUE) {
+	while (current.getType() == ID_ENUM_VALUE) {
 		parseScheme();
-		schemeList();
 	}
 }
 void DatalogParser::factList(){
-	if (tokens[tokenIndexer].getType() == ID_ENUM_VALUE) {
+	while (current.getType() == ID_ENUM_VALUE) {
 		parseFact();
-		factList();
 	}
 }
 
 void DatalogParser::ruleList(){
-	if (tokens[tokenIndexer].getType() == ID_ENUM_VALUE) {
+	while (current.getType() == ID_ENUM_VALUE) {
 		parseRule();
-		ruleList();
 	}
 }
 
 void DatalogParser::queryList(){
-	if (tokens[tokenIndexer].getType() == ID_ENUM_VALUE) {
+	while (current.getType() == ID_ENUM_VALUE) {
 		parseQuery();
-		queryList();
 	}
 }
 
 void DatalogParser::predicateList(Rule &rule){
-	if(tokens[tokenIndexer].getValue() == ",") {
+	while(current.getType() == Token::COMMA) {
 		Predicate pred;
-		tokenIndexer++;
+		advance();
 		parsePredicate(pred);
 		rule.addPredicates(pred);
-		predicateList(rule);
 	}
 }
 
 void DatalogParser::parameterList(Predicate &pred){
-	if(tokens[tokenIndexer].getValue() == ","){
-		tokenIndexer++;
+	while(current.getType() == Token::COMMA){
+		advance();
 		parseParameter(pred);
-		parameterList(pred);
 	}
 }
 
-void DatalogParser::match(string value){
-	if(tokens[tokenIndexer].getValue() == value) {
-		tokenIndexer++;
+void DatalogParser::match(StringView value){
+	if(current.getText() == value) {
+		advance();
 	}
 	else {
-		throw tokens[tokenIndexer];
+		throw current;
 	}
 }
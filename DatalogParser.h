@@ -3,28 +3,39 @@
 #include "Rule.h"
 #include "Predicate.h"
 #include "Token.h"
+#include "Scanner.h"
+#include "StringView.h"
+#include "Relation.h"
+#include "Tuple.h"
 #include <iostream>
 #include <vector>
 #include <set>
+#include <map>
 using namespace std;
 
 class DatalogParser {
 
 private:
-	set<string> domains;
-	vector<Token> tokens;
+	set<int> domains;
+	Scanner& scanner;
+	Token current;
 	vector<Predicate> schemesList;
-	vector<Predicate> factsList;
+	map<string, Relation> facts;
+	Relation* factRelation;
+	string factName;
+	Tuple factTuple;
+	string text;
+	int factCount;
 	vector<Rule> rulesList;
 	vector<Predicate> queriesList;
-	int tokenIndexer;
 	const int STRING_ENUM_VALUE = 12;
 	const int ID_ENUM_VALUE = 11;
 
 public:
-	DatalogParser(vector<Token>&);
+	DatalogParser(Scanner&);
 	vector<Predicate> getSchemesList();
-	vector<Predicate> getFactsList();
+	map<string, Relation>& getFacts();
+	int getFactCount();
 	vector<Rule> getRulesList();
 	vector<Predicate> getQueriesList();
 	void parseFile(string);
@@ -32,6 +43,7 @@ public:
 	void parseFact();
 	void parseRule();
 	void parseQuery();
+	bool parseQueryText(Predicate&);
 	void parsePredicate(Predicate &);
 	void parseParameter(Predicate &);
 	void writeOutput(string&);
@@ -41,5 +53,8 @@ public:
 	void queryList();
 	void predicateList(Rule &);
 	void parameterList(Predicate &);
-	void match(string);
+	void advance();
+	int internText();
+	void parseFactValue();
+	void match(StringView);
 };
\ No newline at end of file
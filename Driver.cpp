@@ -5,12 +5,35 @@
 #include "Token.h"
 #include "DatalogParser.h"
 #include "Interpreter.h"
+#include "Profiler.h"
+#include "ChangeSet.h"
+#include "QueryServer.h"
 using namespace std;
 
 int main(int argc, char *argv[]) {
 	string fileName = argv[1];
+	string profileFile;
+	for (int i = 3; i < argc; ++i) {
+		string option = argv[i];
+		if (option == "--profile") {
+			profileFile = string(argv[2]) + ".profile.json";
+		}
+		else if (option.compare(0, 10, "--profile=") == 0) {
+			profileFile = option.substr(10);
+		}
+	}
+	Profiler profiler;
+	chrono::steady_clock::time_point start = Profiler::now();
+	if (profileFile != "") {
+		Scanner lexer;
+		lexer.open(fileName);
+		while (lexer.next().getType() != Token::EoF) {
+		}
+		profiler.addPhase("scan", Profiler::since(start));
+		start = Profiler::now();
+	}
     Scanner scan;
-    vector<Token> tokens = scan.executeScan(fileName);
+    scan.open(fileName);
 	ofstream outputFile;
     /*string outFile = argv[2];
     outputFile.open(outFile);
@@ -32,12 +55,128 @@ int main(int argc, char *argv[]) {
 	}
     outputFile.close();*/
 
-	DatalogParser parser(tokens);
+	DatalogParser parser(scan);
 	parser.parseFile(argv[2]);
 	Interpreter interpreter(parser, argv[2]);
+	if (profileFile != "") {
+		interpreter.setProfiler(&profiler);
+		profiler.addPhase("parse", Profiler::since(start));
+	}
+	string loadFile;
+	string saveFile;
+	vector<pair<string, string>> imports;
+	vector<string> updates;
+	bool stats = false;
+	bool serve = false;
+	string socketFile;
+	for (int i = 3; i < argc; ++i) {
+		string option = argv[i];
+		if (option.compare(0, 10, "--threads=") == 0) {
+			interpreter.setThreads(stoi(option.substr(10)));
+		}
+		else if (option == "--jacobi") {
+			interpreter.setJacobi(true);
+		}
+		else if (option.compare(0, 16, "--load-snapshot=") == 0) {
+			loadFile = option.substr(16);
+		}
+		else if (option.compare(0, 16, "--save-snapshot=") == 0) {
+			saveFile = option.substr(16);
+		}
+		else if (option.compare(0, 14, "--query-cache=") == 0) {
+			interpreter.getQueryCache().setBudget(stoull(option.substr(14)));
+		}
+		else if (option == "--quiet" || option == "--output=quiet") {
+			interpreter.setOutputLevel(Interpreter::QUIET);
+		}
+		else if (option == "--output=full") {
+			interpreter.setOutputLevel(Interpreter::FULL_OUTPUT);
+		}
+		else if (option == "--output=no-graphs") {
+			interpreter.setOutputLevel(Interpreter::NO_GRAPHS);
+		}
+		else if (option == "--output=no-derivations") {
+			interpreter.setOutputLevel(Interpreter::NO_DERIVATIONS);
+		}
+		else if (option == "--stats") {
+			stats = true;
+		}
+		else if (option.compare(0, 9, "--update=") == 0) {
+			updates.push_back(option.substr(9));
+			interpreter.setIncremental(true);
+		}
+		else if (option == "--serve") {
+			serve = true;
+			interpreter.setIncremental(true);
+		}
+		else if (option.compare(0, 8, "--serve=") == 0) {
+			serve = true;
+			socketFile = option.substr(8);
+			interpreter.setIncremental(true);
+		}
+		else if (option.compare(0, 9, "--import=") == 0 && option.find('=', 9) != string::npos) {
+			size_t split = option.find('=', 9);
+			imports.push_back({ option.substr(9, split - 9), option.substr(split + 1) });
+		}
+	}
+	start = Profiler::now();
 	interpreter.evaluateSchemes();
+	if (loadFile != "" && !interpreter.loadSnapshot(loadFile)) {
+		cerr << "Could not load snapshot " << loadFile << endl;
+		return 1;
+	}
+	for (size_t i = 0; i < imports.size(); ++i) {
+		if (!interpreter.importFacts(imports[i].first, imports[i].second)) {
+			cerr << "Could not import " << imports[i].second << " into " << imports[i].first << endl;
+			return 1;
+		}
+	}
 	interpreter.evaluateFacts();
+	if (saveFile != "" && !interpreter.saveSnapshot(saveFile)) {
+		cerr << "Could not save snapshot " << saveFile << endl;
+		return 1;
+	}
+	profiler.addPhase("facts", Profiler::since(start));
+	start = Profiler::now();
 	interpreter.evaluateRules();
+	profiler.addPhase("rules", Profiler::since(start));
+	for (size_t i = 0; i < updates.size(); ++i) {
+		start = Profiler::now();
+		ChangeSet changes;
+		if (!changes.load(updates[i])) {
+			cerr << "Could not read changes from " << updates[i];
+			if (changes.getErrorLine() > 0) {
+				cerr << " (line " << changes.getErrorLine() << ")";
+			}
+			cerr << endl;
+			return 1;
+		}
+		if (!interpreter.evaluateChanges(changes)) {
+			cerr << "Could not apply changes from " << updates[i] << endl;
+			return 1;
+		}
+		profiler.addPhase("update", Profiler::since(start));
+	}
+	start = Profiler::now();
 	interpreter.evaluateQueries();
+	profiler.addPhase("queries", Profiler::since(start));
+	if (stats) {
+		QueryCache& cache = interpreter.getQueryCache();
+		cerr << "query cache: " << cache.getHits() << " hits, " << cache.getMisses() << " misses, " << cache.memoryUsage() << " bytes" << endl;
+	}
+	if (profileFile != "" && !profiler.save(profileFile)) {
+		cerr << "Could not write profile " << profileFile << endl;
+		return 1;
+	}
+	if (serve) {
+		QueryServer server(interpreter);
+		if (socketFile == "") {
+			server.serve(cin, cout);
+		}
+		else if (!server.listen(socketFile)) {
+			cerr << "Could not listen on " << socketFile << endl;
+			return 1;
+		}
+	}
 	return 0;
 }
@@ -0,0 +1,133 @@
+#include "FactImporter.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
+#include "Relation.h"
+#include "Tuple.h"
+#include <cstring>
+#include <algorithm>
+
+bool FactImporter::load(Database& database, const string& name, const string& fileName, ThreadPool& pool) {
+	map<string, Relation>& relations = database.getRelations();
+	if (relations.count(name) == 0 || relations.at(name).getScheme().size() == 0) {
+		return false;
+	}
+	MappedFile input;
+	if (!input.open(fileName)) {
+		return false;
+	}
+	int arity = relations.at(name).getScheme().size();
+	char delimiter = delimiterFor(fileName);
+	const char* begin = input.data();
+	const char* end = begin + input.size();
+	int chunkCount = max(1, pool.getThreads() * CHUNKS_PER_THREAD);
+	vector<const char*> bounds(1, begin);
+	for (int i = 1; i < chunkCount; ++i) {
+		const char* bound = begin + input.size() * i / chunkCount;
+		if (bound < bounds.back()) {
+			bound = bounds.back();
+		}
+		const char* newline = (const char*)memchr(bound, '\n', end - bound);
+		bounds.push_back(newline == 0 ? end : newline + 1);
+	}
+	bounds.push_back(end);
+	vector<Chunk> chunks(chunkCount);
+	pool.parallelFor(chunkCount, [&](int i) {
+		parseChunk(bounds[i], bounds[i + 1], delimiter, arity, chunks[i]);
+	});
+	Relation imported;
+	Tuple t;
+	t.resize(arity);
+	vector<int> symbols;
+	for (int i = 0; i < chunkCount; ++i) {
+		Chunk& chunk = chunks[i];
+		if (chunk.failed) {
+			return false;
+		}
+		symbols.resize(chunk.values.size());
+		for (size_t id = 0; id < chunk.values.size(); ++id) {
+			symbols[id] = SymbolTable::intern(*chunk.values[id]);
+		}
+		for (size_t k = 0; k < chunk.tuples.size(); k += arity) {
+			for (int column = 0; column < arity; ++column) {
+				t[column] = symbols[chunk.tuples[k + column]];
+			}
+			imported.setTuples(t);
+		}
+		unordered_map<string, int>().swap(chunk.ids);
+		vector<int>().swap(chunk.tuples);
+	}
+	database.loadFacts(name, imported);
+	return true;
+}
+
+char FactImporter::delimiterFor(const string& fileName) {
+	size_t dot = fileName.rfind('.');
+	if (dot != string::npos && (fileName.substr(dot) == ".tsv" || fileName.substr(dot) == ".tab")) {
+		return '\t';
+	}
+	return ',';
+}
+
+void FactImporter::parseChunk(const char* position, const char* end, char delimiter, int arity, Chunk& chunk) {
+	string field;
+	while (position < end) {
+		const char* lineEnd = (const char*)memchr(position, '\n', end - position);
+		if (lineEnd == 0) {
+			lineEnd = end;
+		}
+		const char* last = lineEnd;
+		if (last > position && last[-1] == '\r') {
+			--last;
+		}
+		if (last > position) {
+			int columns = 0;
+			const char* current = position;
+			while (current <= last && columns <= arity) {
+				current = nextField(current, last, delimiter, field);
+				pair<unordered_map<string, int>::iterator, bool> result = chunk.ids.insert({ field, (int)chunk.values.size() });
+				if (result.second) {
+					chunk.values.push_back(&result.first->first);
+				}
+				chunk.tuples.push_back(result.first->second);
+				++columns;
+			}
+			if (columns != arity) {
+				chunk.failed = true;
+				return;
+			}
+		}
+		position = lineEnd + 1;
+	}
+}
+
+const char* FactImporter::nextField(const char* position, const char* end, char delimiter, string& field) {
+	field = "'";
+	if (position < end && *position == '"' && delimiter == ',') {
+		++position;
+		while (position < end) {
+			if (*position == '"') {
+				if (position + 1 < end && position[1] == '"') {
+					field += '"';
+					position += 2;
+					continue;
+				}
+				++position;
+				break;
+			}
+			field += *position++;
+		}
+		while (position < end && *position != delimiter) {
+			field += *position++;
+		}
+	}
+	else {
+		const char* stop = (const char*)memchr(position, delimiter, end - position);
+		if (stop == 0) {
+			stop = end;
+		}
+		field.append(position, stop - position);
+		position = stop;
+	}
+	field += '\'';
+	return position + 1;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Database.h"
+#include "ThreadPool.h"
+#include "StringView.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+class FactImporter {
+
+	public:
+		static bool load(Database&, const string&, const string&, ThreadPool&);
+		static char delimiterFor(const string&);
+	private:
+		struct Chunk {
+			unordered_map<string, int> ids;
+			vector<const string*> values;
+			vector<int> tuples;
+			bool failed;
+			Chunk() : failed(false) {}
+		};
+		static void parseChunk(const char*, const char*, char, int, Chunk&);
+		static const char* nextField(const char*, const char*, char, string&);
+		static const int CHUNKS_PER_THREAD = 4;
+};
@@ -1,101 +1,115 @@
-#include <set>
-#include <map>
-#include <vector>
-using namespace std;
+#include "Graph.h"
+#include <algorithm>
 
+Graph::Graph() : offsets(1, 0) {}
 
-int main() {
-
-}
-
-void createDependencyGraph() {
-	map<string, set<int>> ruleNumbers;
-	for (size_t i = 0; i < rulesList.size(); ++i) {
-		set<int> dependPositions;
-		Predicate leftPred = rulesList[i].getPred();
-		string predName = leftPred.getID();
-		if (ruleNumbers.count(predName) > 0) {
-			dependPositions = ruleNumbers.at(predName);
-		}
-		dependPositions.insert(i);
-		pair<string, set<int>> ruleNumber = { predName, dependPositions };
-		ruleNumbers.insert(ruleNumber);
+Graph::Graph(int nodes, vector<pair<int, int>>& edges) : offsets(nodes + 1, 0) {
+	for (size_t i = 0; i < edges.size(); ++i) {
+		++offsets[edges[i].first + 1];
 	}
-	vector<set<int>> dependGraph;
-	for (size_t i = 0; i < rulesList.size(); ++i) {
-		vector<Predicate> rightPreds = rulesList[i].getPreds();
-		set<int> dependencies;
-		for (size_t j = 0; j < rightPreds.size(); ++j) {
-			Predicate predicate = rightPreds[j];
-			string ruleName = predicate.getID();
-			if (ruleNumbers.count(ruleName) > 0) {
-				dependencies.insert(ruleNumbers.at(name).begin(), ruleNumbers.at(name).end());
-			}
-		} 
-		dependGraph.push_back(dependencies);
+	for (int node = 0; node < nodes; ++node) {
+		offsets[node + 1] += offsets[node];
 	}
-}
-
-void createReverseGraph(vector<set<int>>& dependGraph) {
-	vector<set<int>> reverseGraph;
-	for (size_t i = 0; i < dependGraph.size(); ++i) {
-		set<int> d;
-		reverseGraph.push_back(d);
+	targets.resize(edges.size());
+	vector<int> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < edges.size(); ++i) {
+		targets[fill[edges[i].first]++] = edges[i].second;
 	}
-
-	for (size_t i = 0; i < dependGraph.size(); ++i) {
-		set<int> dependencies = dependGraph[i];
-		for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-			int position = *it;
-			reverseGraph[position].insert(i);
+	int kept = 0;
+	for (int node = 0; node < nodes; ++node) {
+		int first = offsets[node];
+		int last = offsets[node + 1];
+		sort(targets.begin() + first, targets.begin() + last);
+		offsets[node] = kept;
+		for (int i = first; i < last; ++i) {
+			if (i == first || targets[i] != targets[i - 1]) {
+				targets[kept++] = targets[i];
+			}
 		}
 	}
+	offsets[nodes] = kept;
+	targets.resize(kept);
 }
 
-void depthForest(vector<set<int>>& reverseGraph) {
-	set<int> visitHistory;
-	vector<int> postOrderStack;
-	int graphSize = reverseGraph.size();
-	for (int i = 0; i < graphSize; ++i) {
-		if (visitHistory.count(i) == 0) {
-			depthFirstSearch(visitHistory, i, reverseGraph, postOrderStack);
-		}
-	}
+int Graph::size() const {
+	return offsets.size() - 1;
 }
 
-void depthFirstSearch(set<int>& visitHistory, int& index, vector<set<int>>& reverseGraph, vector<int>& postOrderStack) {
-	visitHistory.insert(index);
-	set<int> dependencies = reverseGraph[index];
-	for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-		int position = *it;
-		if (visitHistory.count(position) == 0)
-			depthFirstSearch(visitHistory, position, reverseGraph, postOrderStack);
-	}
-	postOrderStack.push_back(index);
+const int* Graph::begin(int node) const {
+	return targets.data() + offsets[node];
 }
 
-void findStrongConnections(vector<int>& postOrderStack, vector<set<int>>& dependencyGraph) {
-	vector<set<int>> postOrder;
-	set<int> visitHistory;
-
-	for (size_t i = 0; i < postOrderStack.size(); ++i) {
+const int* Graph::end(int node) const {
+	return targets.data() + offsets[node + 1];
+}
 
-		set<int> strongConnection;
-		int rulePosition = postOrderStack[i];
-		strongConnection.insert(rulePosition);
-		visitHistory.insert(rulePosition);
-		set<int> dependencies = dependencyGraph[rulePosition];
+bool Graph::hasEdge(int from, int to) const {
+	return binary_search(begin(from), end(from), to);
+}
 
-		for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
+Graph Graph::reverse() const {
+	vector<pair<int, int>> edges;
+	edges.reserve(targets.size());
+	for (int node = 0; node < size(); ++node) {
+		for (const int* it = begin(node); it != end(node); ++it) {
+			edges.push_back({ *it, node });
+		}
+	}
+	return Graph(size(), edges);
+}
 
-			int ruleNumber = *it;
-			if (visitHistory.count(ruleNumber) == 0) {
-				strongConnection.insert(ruleNumber);
-				visitHistory.insert(ruleNumber);
+vector<int> Graph::postOrder() const {
+	vector<int> finished;
+	finished.reserve(size());
+	vector<bool> visited(size(), false);
+	vector<pair<int, const int*>> stack;
+	for (int root = 0; root < size(); ++root) {
+		if (visited[root]) {
+			continue;
+		}
+		visited[root] = true;
+		stack.push_back({ root, begin(root) });
+		while (!stack.empty()) {
+			pair<int, const int*>& top = stack.back();
+			if (top.second == end(top.first)) {
+				finished.push_back(top.first);
+				stack.pop_back();
+				continue;
+			}
+			int next = *top.second++;
+			if (!visited[next]) {
+				visited[next] = true;
+				stack.push_back({ next, begin(next) });
 			}
 		}
-		postOrder.push_back(strongConnection);
 	}
+	return finished;
 }
 
-//evaluate rules in new order
\ No newline at end of file
+vector<vector<int>> Graph::components(const vector<int>& order) const {
+	vector<vector<int>> found;
+	vector<bool> visited(size(), false);
+	vector<int> stack;
+	for (size_t i = 0; i < order.size(); ++i) {
+		if (visited[order[i]]) {
+			continue;
+		}
+		vector<int> component;
+		visited[order[i]] = true;
+		stack.push_back(order[i]);
+		while (!stack.empty()) {
+			int node = stack.back();
+			stack.pop_back();
+			component.push_back(node);
+			for (const int* it = begin(node); it != end(node); ++it) {
+				if (!visited[*it]) {
+					visited[*it] = true;
+					stack.push_back(*it);
+				}
+			}
+		}
+		sort(component.begin(), component.end());
+		found.push_back(component);
+	}
+	return found;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+#include <utility>
+using namespace std;
+
+class Graph {
+
+	public:
+		Graph();
+		Graph(int, vector<pair<int, int>>&);
+		int size() const;
+		const int* begin(int) const;
+		const int* end(int) const;
+		bool hasEdge(int, int) const;
+		Graph reverse() const;
+		vector<int> postOrder() const;
+		vector<vector<int>> components(const vector<int>&) const;
+	private:
+		vector<int> offsets;
+		vector<int> targets;
+};
@@ -1,22 +1,111 @@
 #include "Interpreter.h"
 #include "Parameter.h"
+#include "Snapshot.h"
+#include "FactImporter.h"
+#include "SymbolTable.h"
+#include "ChangeSet.h"
+#include <algorithm>
 using namespace std;
 
-Interpreter::Interpreter(DatalogParser parser, string fileName) {
-	Database database;
+Interpreter::Interpreter(DatalogParser& parser, string fileName) {
+	threads = ThreadPool::defaultThreads();
+	jacobi = false;
+	profiler = 0;
+	outputLevel = FULL_OUTPUT;
+	incremental = false;
 	output.open(fileName);
 	schemesList = parser.getSchemesList();
-	factsList = parser.getFactsList();
+	facts.swap(parser.getFacts());
+	factCount = parser.getFactCount();
 	rulesList = parser.getRulesList();
 	queriesList = parser.getQueriesList();
 }
 
+void Interpreter::setThreads(int threads) {
+	this->threads = threads;
+}
+
+void Interpreter::setJacobi(bool jacobi) {
+	this->jacobi = jacobi;
+}
+
+void Interpreter::setProfiler(Profiler* profiler) {
+	this->profiler = profiler;
+}
+
+void Interpreter::setOutputLevel(OutputLevel outputLevel) {
+	this->outputLevel = outputLevel;
+}
+
+void Interpreter::setIncremental(bool incremental) {
+	this->incremental = incremental;
+}
+
+set<string> Interpreter::derivedNames() {
+	set<string> derived;
+	for (unsigned int i = 0; i < rulesList.size(); ++i) {
+		derived.insert(rulesList[i].getPred().getID());
+	}
+	return derived;
+}
+
+bool Interpreter::loadSnapshot(string fileName) {
+	int before = database.getTupleCount();
+	if (!Snapshot::load(database, fileName)) {
+		return false;
+	}
+	factCount += database.getTupleCount() - before;
+	set<string> derived = derivedNames();
+	map<string, Relation>& relations = database.getRelations();
+	for (map<string, Relation>::iterator it = relations.begin(); it != relations.end(); ++it) {
+		if (derived.count(it->first) == 0) {
+			it->second.setLayout(TupleStore::COLUMN);
+		}
+	}
+	return true;
+}
+
+bool Interpreter::importFacts(string name, string fileName) {
+	int before = database.getTupleCount();
+	if (!FactImporter::load(database, name, fileName, workers())) {
+		return false;
+	}
+	factCount += database.getTupleCount() - before;
+	if (derivedNames().count(name) == 0) {
+		database.getRelation(name).setLayout(TupleStore::COLUMN);
+	}
+	return true;
+}
+
+ThreadPool& Interpreter::workers() {
+	if (!pool) {
+		pool.reset(new ThreadPool(threads));
+	}
+	return *pool;
+}
+
+Database& Interpreter::getDatabase() {
+	return database;
+}
+
+QueryCache& Interpreter::getQueryCache() {
+	return queryCache;
+}
+
+bool Interpreter::saveSnapshot(string fileName) {
+	return Snapshot::save(database, fileName);
+}
+
 void Interpreter::evaluateSchemes() {
 	output << "Scheme Evaluation" << endl << endl;
+	set<string> derived = derivedNames();
     for (unsigned int i = 0; i < schemesList.size(); ++i) {
 		Relation newRelation;
 		string name = schemesList[i].getID();
 		newRelation.setName(name);
+		if (derived.count(name) == 0) {
+			newRelation.setLayout(TupleStore::COLUMN);
+		}
         for (unsigned int j = 0; j < schemesList[i].getParams().size(); j++) {
 			Parameter p = schemesList[i].getParams()[j];
 			string value = p.getValue();
@@ -29,144 +118,512 @@ void Interpreter::evaluateSchemes() {
 
 void Interpreter::evaluateFacts() {
 	output << "Fact Evaluation" << endl << endl;
-	set<string> factNames;
-    for (unsigned int i = 0; i < schemesList.size(); ++i) {
-        string factName = schemesList[i].getID();
-        factNames.insert(factName);
-    }
-    for (unsigned int i = 0; i < factsList.size(); ++i) {
-		Tuple tuple;
-		string factName = factsList[i].getID();
-		factNames.insert(factName);
-        for (unsigned int j = 0; j < factsList[i].getParams().size(); ++j) {
-			Parameter p = factsList[i].getParams()[j];
-			string value = p.getValue();
-			tuple.push_back(value);
-        }
-		database.setTuple(factName, tuple);
+	for (map<string, Relation>::iterator it = facts.begin(); it != facts.end(); ++it) {
+		database.loadFacts(it->first, it->second);
 	}
-	for (auto& names : factNames) {
-        output << database.getRelations()[names].toString(true) << endl;
+	map<string, Relation>().swap(facts);
+	for (auto& relation : database.getRelations()) {
+		if (outputLevel < QUIET) {
+			relation.second.write(output, true);
+			output << '\n';
+		}
+		profileRelation(relation.first);
+	}
+	if (incremental) {
+		baseFacts = database.getRelations();
 	}
 }
 
 void Interpreter::evaluateQueries() {
     output << "Query Evaluation" << endl << endl;
 	for (unsigned int i = 0; i < queriesList.size(); i++) {
-		output << queriesList[i].toString() << "?";
-		string name = queriesList[i].getID();
-		Relation r = database.getRelations()[name];
+		answerQuery(queriesList[i], output);
+    }
+	for (auto& relation : database.getRelations()) {
+		profileRelation(relation.first);
+	}
+    output.close();
+}
+
+bool Interpreter::canAnswer(Predicate& query) {
+	map<string, Relation>& relations = database.getRelations();
+	map<string, Relation>::iterator it = relations.find(query.getID());
+	return it != relations.end() && query.getParams().size() == it->second.getScheme().size();
+}
+
+void Interpreter::answerQuery(Predicate& query, OutputWriter& log) {
+	log << query.toString() << "?";
+	string name = query.getID();
+	vector<int> varPos;
+	vector<string> varName;
+	map<string, int> variables;
+	vector<int> columns;
+	vector<int> values;
+	vector<pair<int, int>> equal;
+	string key = name + "(";
+	//select for loops
+	vector<Parameter>& params = query.getParams();
+	int paramSize = params.size();
+	for (int j = 0; j < paramSize; ++j) {
+		Parameter& p1 = params[j];
+		string value = p1.getValue();
+		if (variables.count(value) == 0 && p1.getisID()) {
+			key += "?" + to_string(variables.size()) + ",";
+			variables[value] = j;
+			varPos.push_back(j);
+			varName.push_back(value);
+		}
+		else if (!p1.getisID()) {
+			key += "#" + to_string(p1.getSymbol()) + ",";
+			columns.push_back(j);
+			values.push_back(p1.getSymbol());
+		}
+		else {
+			key += "?" + to_string(find(varName.begin(), varName.end(), value) - varName.begin()) + ",";
+			equal.push_back({ variables[value], j });
+		}
+	}
+	key += ")";
+	QueryCache::Result result;
+	bool cached = false;
+	{
+		lock_guard<mutex> guard(queryLock);
+		const QueryCache::Result* entry = queryCache.find(key);
+		if (entry != 0) {
+			result = *entry;
+			cached = true;
+		}
+	}
+	if (!cached) {
+		map<string, Relation>& relations = database.getRelations();
+		map<string, Relation>::iterator it = relations.find(name);
+		Relation r = it != relations.end() ? it->second : Relation();
 		bool found = false;
-		vector<int> varPos;
-		vector<string> varName;
-		map<string, int> variables;
-		//select for loops
-		int paramSize = queriesList[i].getParams().size();
-        for (int j = 0; j < paramSize; ++j) {
-			Parameter p1 = queriesList[i].getParams()[j];
-			string value = p1.getValue();
-			if (variables.count(value) == 0 && p1.getisID()) {
-				variables[value] = j;
-				varPos.push_back(j);
-				varName.push_back(value);
-			}
-			else if (!p1.getisID()) {
-				found = r.selectValue(j, p1.getValue());
-			}
-			else {
-				found = r.selectVariables(variables[p1.getValue()], j);
+		if (!columns.empty() || !equal.empty()) {
+			found = r.selectWhere(columns, values, equal);
+		}
+		OutputWriter text;
+		interpPrint(found, r, query, text);
+		//project for loops
+		interpProject(found, varName, varPos, r, text);
+		result.text = text.str();
+		result.found = found;
+		result.arity = 0;
+		if (found && varName.size() > 0) {
+			result.scheme = r.getScheme();
+			result.arity = r.getArity();
+			vector<int> sorted = r.sortedRows();
+			for (size_t k = 0; k < sorted.size(); ++k) {
+				for (int j = 0; j < result.arity; ++j) {
+					result.rows.push_back(r.get(sorted[k], j));
+				}
 			}
 		}
-        interpPrint(found, varName, r, i);
-        //project for loops
-        interpProject(found, varName, varPos, r);
-        //rename
-        interpRename(found,varName,varPos,r);
-    }
-    output.close();
+		lock_guard<mutex> guard(queryLock);
+		queryCache.insert(key, result);
+	}
+	log << result.text;
+	//rename
+	interpRename(varName, result, log);
 }
 
 void Interpreter::evaluateRules() {
 	output << "Rule Evaluation" << endl << endl;
-	vector<set<int>> dependGraph = createDependencyGraph();
-	vector<set<int>> reverseGraph = createReverseGraph(dependGraph);
-	vector<int> postOrderStack = depthForest(reverseGraph);
-	vector<set<int>> postOrder = findStrongConnections(postOrderStack, dependGraph);
-	output << "Dependency Graph" << endl;
-	printGraphs(dependGraph);
-	output << "Reverse Graph" << endl;
-	printGraphs(reverseGraph);
-	output << "Postorder Numbers" << endl;
-	printOther(postOrderStack, postOrder);
+	Graph dependGraph = createDependencyGraph();
+	Graph reverseGraph = dependGraph.reverse();
+	vector<int> finished = reverseGraph.postOrder();
+	vector<vector<int>> postOrder = dependGraph.components(vector<int>(finished.rbegin(), finished.rend()));
+	if (outputLevel < NO_GRAPHS) {
+		output << "Dependency Graph" << endl;
+		printGraphs(dependGraph);
+		output << "Reverse Graph" << endl;
+		printGraphs(reverseGraph);
+		output << "Postorder Numbers" << endl;
+		printOther(finished, postOrder);
+	}
 	int postSize = postOrder.size();
-	map<string, Relation> relations = database.getRelations();
+	vector<vector<int>> successors = scheduleComponents(postOrder);
+	vector<int> waiting(postSize, 0);
 	for (int i = 0; i < postSize; ++i) {
-		bool relyOnSelf = false;
-		int value = *(postOrder[i].begin());
-		set<int> dependencies = dependGraph[value];
-		set<int> rules = postOrder[i];
-		output << endl << "SCC: R";
-		for (set<int>::iterator it = rules.begin(); it != rules.end(); ) {
-			output << to_string(*it);
-			++it;
-			if (it != rules.end())
-				output << " R";
-			else
-				output << endl;
-		}
-		if (dependencies.size() > 0) {
-			for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it)
-			if (*it == value) {
-				relyOnSelf = true;
-				break;
+		for (size_t j = 0; j < successors[i].size(); ++j) {
+			++waiting[successors[i][j]];
+		}
+	}
+	if (profiler) {
+		vector<string> texts;
+		for (size_t i = 0; i < rulesList.size(); ++i) {
+			texts.push_back(rulesList[i].toString());
+		}
+		profiler->setRules(texts);
+		profiler->setComponents(postSize);
+		for (int i = 0; i < postSize; ++i) {
+			Profiler::ComponentProfile& component = profiler->component(i);
+			component.rules = postOrder[i];
+			component.recursive = postOrder[i].size() > 1 || dependGraph.hasEdge(postOrder[i][0], postOrder[i][0]);
+			for (size_t k = 0; k < component.rules.size(); ++k) {
+				profiler->rule(component.rules[k]).component = i;
 			}
 		}
-		if (postOrder[i].size() == 1 && !relyOnSelf) {
-			singleRun(value);
+	}
+	vector<string> logs(postSize);
+	mutex scheduleLock;
+	workers();
+	function<void(int)> run = [&](int i) {
+		OutputWriter log;
+		chrono::steady_clock::time_point start = Profiler::now();
+		evaluateComponent(postOrder[i], dependGraph, log);
+		if (profiler) {
+			profiler->component(i).seconds = Profiler::since(start);
 		}
-		else
-			fixedPointRun(postOrder[i]);
+		vector<int> ready;
+		{
+			lock_guard<mutex> guard(scheduleLock);
+			logs[i] = log.str();
+			for (size_t j = 0; j < successors[i].size(); ++j) {
+				if (--waiting[successors[i][j]] == 0) {
+					ready.push_back(successors[i][j]);
+				}
+			}
+		}
+		for (size_t j = 0; j < ready.size(); ++j) {
+			int next = ready[j];
+			pool->submit([&run, next] { run(next); });
+		}
+	};
+	vector<int> roots;
+	for (int i = 0; i < postSize; ++i) {
+		if (waiting[i] == 0) {
+			roots.push_back(i);
+		}
+	}
+	for (size_t i = 0; i < roots.size(); ++i) {
+		int root = roots[i];
+		pool->submit([&run, root] { run(root); });
+	}
+	pool->wait();
+	for (int i = 0; i < postSize && outputLevel < QUIET; ++i) {
+		output << logs[i];
 	}
 	
 	output << endl << "Rule Evaluation Complete" << endl << endl;
-	output << database.toString();
+	if (outputLevel < QUIET) {
+		database.write(output);
+	}
+}
+bool Interpreter::evaluateChanges(ChangeSet& changes) {
+	return applyChanges(changes, output);
+}
+
+bool Interpreter::applyChanges(ChangeSet& changes, OutputWriter& log) {
+	map<string, Relation>& inserts = changes.getInserts();
+	map<string, Relation>& deletes = changes.getDeletes();
+	if (!incremental || !validChanges(inserts) || !validChanges(deletes)) {
+		return false;
+	}
+	{
+		lock_guard<mutex> guard(queryLock);
+		queryCache.clear();
+	}
+	map<string, Relation>& relations = database.getRelations();
+	map<string, Relation> removed;
+	int retracted = retractFacts(deletes, removed);
+	int overdeleted = overdelete(removed);
+	map<string, int> marks;
+	for (map<string, Relation>::iterator it = relations.begin(); it != relations.end(); ++it) {
+		marks[it->first] = it->second.size();
+	}
+	int rederived = rederive(removed);
+	int inserted = 0;
+	for (map<string, Relation>::iterator it = inserts.begin(); it != inserts.end(); ++it) {
+		inserted += baseFacts.at(it->first).addTuples(it->second);
+		database.addTuples(it->first, it->second);
+	}
+	factCount += inserted - retracted;
+	int propagated = propagate(marks);
+	log << "Incremental Update" << endl;
+	log << "  Facts inserted: " << inserted << endl;
+	log << "  Facts retracted: " << retracted << endl;
+	log << "  Tuples overdeleted: " << overdeleted << endl;
+	log << "  Tuples rederived: " << rederived << endl;
+	log << "  Tuples propagated: " << propagated << endl << endl;
+	return true;
+}
+
+bool Interpreter::validChanges(map<string, Relation>& changed) {
+	for (map<string, Relation>::iterator it = changed.begin(); it != changed.end(); ++it) {
+		if (baseFacts.count(it->first) == 0 || it->second.getArity() != (int)baseFacts.at(it->first).getScheme().size()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int Interpreter::retractFacts(map<string, Relation>& deletes, map<string, Relation>& removed) {
+	int retracted = 0;
+	Tuple t;
+	for (map<string, Relation>::iterator it = deletes.begin(); it != deletes.end(); ++it) {
+		Relation& base = baseFacts.at(it->first);
+		Relation gone = base.sliceFrom(base.size());
+		for (int row = 0; row < it->second.size(); ++row) {
+			it->second.readRow(row, t);
+			if (base.contains(t)) {
+				gone.setTuples(t);
+			}
+		}
+		if (gone.size() > 0) {
+			retracted += base.removeTuples(gone);
+			removed[it->first] = gone;
+		}
+	}
+	return retracted;
+}
+
+int Interpreter::overdelete(map<string, Relation>& removed) {
+	map<string, Relation>& relations = database.getRelations();
+	map<string, Relation> frontier = removed;
+	Tuple t;
+	while (!frontier.empty()) {
+		map<string, Relation> next;
+		for (size_t i = 0; i < rulesList.size(); ++i) {
+			vector<Predicate>& preds = rulesList[i].getPreds();
+			string head = rulesList[i].getPred().getID();
+			Relation& current = relations.at(head);
+			for (size_t j = 0; j < preds.size(); ++j) {
+				map<string, Relation>::iterator delta = frontier.find(preds[j].getID());
+				if (delta == frontier.end()) {
+					continue;
+				}
+				map<int, Relation> deltas;
+				if (!repeatsParameter(preds)) {
+					deltas[j] = delta->second;
+				}
+				Relation derived = evaluateRule(i, relations, deltas);
+				if (removed.count(head) == 0) {
+					removed[head] = current.sliceFrom(current.size());
+				}
+				if (next.count(head) == 0) {
+					next[head] = current.sliceFrom(current.size());
+				}
+				for (int row = 0; row < derived.size(); ++row) {
+					derived.readRow(row, t);
+					if (current.contains(t) && !removed[head].contains(t)) {
+						removed[head].setTuples(t);
+						next[head].setTuples(t);
+					}
+				}
+			}
+		}
+		frontier.clear();
+		for (map<string, Relation>::iterator it = next.begin(); it != next.end(); ++it) {
+			if (it->second.size() > 0) {
+				frontier.insert(*it);
+			}
+		}
+	}
+	int overdeleted = 0;
+	for (map<string, Relation>::iterator it = removed.begin(); it != removed.end(); ++it) {
+		overdeleted += database.removeTuples(it->first, it->second);
+	}
+	return overdeleted;
+}
+
+int Interpreter::rederive(map<string, Relation>& removed) {
+	int rederived = 0;
+	Tuple t;
+	for (map<string, Relation>::iterator it = removed.begin(); it != removed.end(); ++it) {
+		Relation& candidates = it->second;
+		if (candidates.size() == 0) {
+			continue;
+		}
+		Relation& base = baseFacts.at(it->first);
+		Relation restored = candidates.sliceFrom(candidates.size());
+		for (int row = 0; row < candidates.size(); ++row) {
+			candidates.readRow(row, t);
+			if (base.contains(t)) {
+				restored.setTuples(t);
+			}
+		}
+		for (size_t i = 0; i < rulesList.size(); ++i) {
+			if (rulesList[i].getPred().getID() != it->first) {
+				continue;
+			}
+			Relation derived = seededRule(i, candidates);
+			for (int row = 0; row < derived.size(); ++row) {
+				derived.readRow(row, t);
+				if (candidates.contains(t)) {
+					restored.setTuples(t);
+				}
+			}
+		}
+		rederived += database.addTuples(it->first, restored);
+	}
+	return rederived;
+}
+
+Relation Interpreter::seededRule(int i, Relation& candidates) {
+	map<int, Relation> deltas;
+	Rule seeded;
+	seeded.setPred(rulesList[i].getPred());
+	seeded.addPredicates(rulesList[i].getPred());
+	for (size_t j = 0; j < rulesList[i].getPreds().size(); ++j) {
+		seeded.addPredicates(rulesList[i].getPreds()[j]);
+	}
+	if (repeatsParameter(seeded.getPreds())) {
+		return evaluateRule(i, database.getRelations(), deltas);
+	}
+	deltas[0] = candidates;
+	return evaluateRule(seeded, i, database.getRelations(), deltas);
+}
+
+bool Interpreter::changedSince(vector<Predicate>& preds, vector<int>& marks) {
+	for (size_t j = 0; j < preds.size(); ++j) {
+		if (database.getRelation(preds[j].getID()).size() != marks[j]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int Interpreter::propagate(map<string, int>& marks) {
+	vector<vector<int>> seen(rulesList.size());
+	for (size_t i = 0; i < rulesList.size(); ++i) {
+		vector<Predicate>& preds = rulesList[i].getPreds();
+		for (size_t j = 0; j < preds.size(); ++j) {
+			seen[i].push_back(marks.at(preds[j].getID()));
+		}
+	}
+	int propagated = 0;
+	int added = -1;
+	while (added != 0) {
+		added = 0;
+		for (size_t i = 0; i < rulesList.size(); ++i) {
+			if (repeatsParameter(rulesList[i].getPreds()) && changedSince(rulesList[i].getPreds(), seen[i])) {
+				seen[i].clear();
+			}
+			Relation newRelation = deriveFacts(i, seen[i]);
+			added += unionFacts(newRelation);
+		}
+		propagated += added;
+	}
+	return propagated;
+}
+
+vector<vector<int>> Interpreter::scheduleComponents(vector<vector<int>>& postOrder) {
+	int postSize = postOrder.size();
+	vector<vector<int>> successors(postSize);
+	map<string, int> lastWriter;
+	map<string, vector<int>> readers;
+	for (int i = 0; i < postSize; ++i) {
+		set<string> reads;
+		set<string> writes;
+		for (size_t k = 0; k < postOrder[i].size(); ++k) {
+			writes.insert(rulesList[postOrder[i][k]].getPred().getID());
+			vector<Predicate>& preds = rulesList[postOrder[i][k]].getPreds();
+			for (size_t j = 0; j < preds.size(); ++j) {
+				reads.insert(preds[j].getID());
+			}
+		}
+		set<int> before;
+		for (set<string>::iterator it = reads.begin(); it != reads.end(); ++it) {
+			if (lastWriter.count(*it) > 0) {
+				before.insert(lastWriter[*it]);
+			}
+		}
+		for (set<string>::iterator it = writes.begin(); it != writes.end(); ++it) {
+			if (lastWriter.count(*it) > 0) {
+				before.insert(lastWriter[*it]);
+			}
+			before.insert(readers[*it].begin(), readers[*it].end());
+		}
+		before.erase(i);
+		for (set<int>::iterator it = before.begin(); it != before.end(); ++it) {
+			successors[*it].push_back(i);
+		}
+		for (set<string>::iterator it = reads.begin(); it != reads.end(); ++it) {
+			readers[*it].push_back(i);
+		}
+		for (set<string>::iterator it = writes.begin(); it != writes.end(); ++it) {
+			lastWriter[*it] = i;
+			readers[*it].clear();
+		}
+	}
+	return successors;
 }
-void Interpreter::interpPrint(bool &found, vector<string>& varName, Relation& r, unsigned int& i) {
-    if (queriesList[i].getParams().size() == r.getScheme().size() && factsList.size() > 0) {
+
+void Interpreter::evaluateComponent(vector<int>& rules, Graph& dependGraph, OutputWriter& log) {
+	int value = rules[0];
+	bool relyOnSelf = dependGraph.hasEdge(value, value);
+	log << endl << "SCC: R";
+	for (size_t k = 0; k < rules.size(); ++k) {
+		log << rules[k];
+		if (k + 1 < rules.size())
+			log << " R";
+		else
+			log << endl;
+	}
+	if (rules.size() == 1 && !relyOnSelf) {
+		singleRun(value, log);
+	}
+	else
+		fixedPointRun(rules, log);
+}
+
+void Interpreter::interpPrint(bool &found, Relation& r, Predicate& query, OutputWriter& log) {
+    if (query.getParams().size() == r.getScheme().size() && factCount > 0) {
         found = true;
-		int size = r.getTuples().size();
+		int size = r.size();
         r.setMatches(size);
     }
     if (found && r.getMatches() > 0) {
-        output << " Yes(" << to_string(r.getMatches()) << ")" << endl << "select" << endl << r.toString(false);
+        log << " Yes(" << r.getMatches() << ")" << endl << "select" << endl;
+		r.write(log, false);
     }
     else {
         found = false;
-        output << " No" << endl << endl;
+        log << " No" << endl << endl;
     }
 }
 
-void Interpreter::interpProject(bool& found, vector<string>& varName, vector<int>& varPos, Relation &r) {
+void Interpreter::interpProject(bool& found, vector<string>& varName, vector<int>& varPos, Relation &r, OutputWriter& log) {
     if (found && varName.size() > 0) {
         r.project(varPos);
-        output << "project" << endl << r.toString(false);
+        log << "project" << endl;
+		r.write(log, false);
     }
     else if(found)
-        output << "project" << endl;
+        log << "project" << endl;
 }
 
-void Interpreter::interpRename(bool& found, vector<string>& varName, vector<int>& varPos, Relation &r) {
-    if (found && varName.size() > 0) {
-        r.rename(varPos, varName);
-        output << "rename" << endl << r.toString(false) << endl;
+void Interpreter::interpRename(vector<string>& varName, const QueryCache::Result& result, OutputWriter& log) {
+    if (result.found && varName.size() > 0) {
+        log << "rename" << endl;
+		const Scheme& scheme = result.scheme;
+		for (size_t row = 0; row + result.arity <= result.rows.size() && result.arity > 0; row += result.arity) {
+			log << "  ";
+			for (size_t j = 0; j < scheme.size(); ++j) {
+				log << (j < varName.size() ? varName[j] : scheme[j]) << '=' << SymbolTable::lookup(result.rows[row + j]);
+				if (j < scheme.size() - 1) {
+					log << ' ';
+				}
+			}
+			log << endl;
+		}
+		log << endl;
     }
-    else if(found)
-        output << "rename" << endl << endl;
+    else if(result.found)
+        log << "rename" << endl << endl;
+}
+
+Relation Interpreter::bodyRelation(vector<Predicate>& preds, int j, map<string, Relation>& relations, map<int, Relation>& deltas) {
+	if (deltas.count(j) > 0) {
+		return deltas.at(j);
+	}
+	return relations.at(preds[j].getID());
 }
 
-void Interpreter::onePredicate(vector<string>& varNames, vector<Predicate>& preds, vector<int>& varPos, Predicate& pred, Relation& newRelation, map<string, Relation>& relations) {
+void Interpreter::onePredicate(vector<string>& varNames, vector<Predicate>& preds, vector<int>& varPos, Predicate& pred, Relation& newRelation, map<string, Relation>& relations, map<int, Relation>& deltas) {
 	
-	Relation r = relations.at(preds[0].getID());
+	Relation r = bodyRelation(preds, 0, relations, deltas);
 	vector<Parameter> params1 = pred.getParams();
 	vector<Parameter> params2 = preds[0].getParams();
 	int param1Size = params1.size();
@@ -188,11 +645,7 @@ void Interpreter::onePredicate(vector<string>& varNames, vector<Predicate>& pred
 
 	findRenameSchemes(pred,varNames);
 	selectLiterals(r,params2, pred);
-	set<Tuple> tuples = r.getTuples();
-	for (set<Tuple>::iterator it = tuples.begin(); it != tuples.end(); ++it) {
-		Tuple t1 = *it;
-		newRelation.setTuples(t1);
-	}	
+	newRelation.addTuples(r);
 }
 
 vector<Parameter> Interpreter::combineSchemes(Relation& r1, Relation& r2, vector<pair<int,int>>& matches, vector<string>& schemes, Relation& newRelation) {
@@ -219,13 +672,14 @@ vector<Parameter> Interpreter::combineSchemes(Relation& r1, Relation& r2, vector
 	return params;
 }
 
-void Interpreter::interpJoin(vector<pair<int,int>>& matches, Relation& newRelation,set<Tuple>& tuples1, set<Tuple>& tuples2) {
-	map<string, Relation> relations = database.getRelations();
+long Interpreter::interpJoin(vector<pair<int,int>>& matches, Relation& newRelation, Relation& r1, Relation& r2) {
 	newRelation.clearTuples();
 	if(matches.size() == 0)
-	matchlessJoin(tuples1, tuples2, newRelation);
+	return matchlessJoin(r1, r2, newRelation);
+	else if (useMergeJoin(matches, r1, r2))
+	return sortMergeJoin(matches, newRelation, r1, r2);
 	else
-	iterateTuples(matches, newRelation, tuples1, tuples2);
+	return hashJoin(matches, newRelation, r1, r2);
 }
 
 void Interpreter::relationJoin(Tuple& t1, Tuple& t2, Relation& newRelation,vector<bool>& match) {
@@ -242,16 +696,8 @@ void Interpreter::relationJoin(Tuple& t1, Tuple& t2, Relation& newRelation,vecto
 	newRelation.setTuples(newTuple);
 }
 
-Relation Interpreter::unionFacts(Relation& newRelation, map<string,Relation>& relations) {
-    set<Tuple> tuples = newRelation.getTuples();
-	Relation tempR = relations.at(newRelation.getName());
-	for (set<Tuple>::iterator it = tuples.begin(); it != tuples.end(); ++it) {
-		Tuple t = *it;
-		tempR.setTuples(t);
-	}
-	pair<string, Relation> pair = { newRelation.getName(), tempR };
-	database.setRelations(pair);
-	return tempR;
+int Interpreter::unionFacts(Relation& newRelation) {
+	return database.addTuples(newRelation.getName(), newRelation);
 }
 
 void Interpreter::setNewSchemes(vector<Parameter>& parameter, vector<int>& varPos, Relation& newRelation) {
@@ -275,53 +721,47 @@ void Interpreter::setNewSchemes(vector<Parameter>& parameter, vector<int>& varPo
 		
 }
 
-Relation Interpreter::findNewFacts(Relation& r1,string name) {
+Relation Interpreter::findNewFacts(Relation& r1, const string& name) {
 	Relation tempR;
-	map<string, Relation> relations = database.getRelations();
-	Relation rData = relations.at(name);
-	set<Tuple> tData = rData.getTuples();
-	set<Tuple> t1 = r1.getTuples();
-	for (set<Tuple>::iterator it = tData.begin(); it != tData.end(); ++it) {
-		Tuple t = *it;
-		t1.erase(t);
-	}
-	for (set<Tuple>::iterator it = t1.begin(); it != t1.end(); ++it) {
-		Tuple t = *it;
-		tempR.setTuples(t);
+	Relation& rData = database.getRelation(name);
+	Tuple t;
+	for (int row = 0; row < r1.size(); ++row) {
+		r1.readRow(row, t);
+		if (!rData.contains(t)) {
+			tempR.setTuples(t);
+		}
 	}
 	return tempR;
 }
 
-void Interpreter::evaluatePredicateJoins(int& i, int& schemeSize, vector<pair<int,int>>& matches, Relation& newRelation, map<string, Relation>& relations) {
+void Interpreter::evaluatePredicateJoins(Rule& rule, int& i, int& schemeSize, vector<pair<int,int>>& matches, Relation& newRelation, map<string, Relation>& relations, map<int, Relation>& deltas) {
 	vector<string> schemes;
 	vector<Parameter> params1;
-	vector<Predicate> preds = rulesList[i].getPreds();
-	Predicate pred1 = rulesList[i].getPred();
+	vector<Predicate> preds = rule.getPreds();
+	Predicate pred1 = rule.getPred();
 	string predName1;
 	map<string, int> match;
 	Relation r1;
-	set<Tuple> tuples1;
+	long probes = 0;
+	vector<int> order = planJoinOrder(preds, relations, deltas);
 
 	for (unsigned int j = 0; j < preds.size(); ++j) {
 		if (j == 0) {
-			params1 = preds[j].getParams();
-			predName1 = preds[j].getID();
-			r1 = relations.at(predName1);
-			findLiterals(r1, params1, pred1);
-			tuples1 = r1.getTuples();
+			params1 = preds[order[j]].getParams();
+			predName1 = preds[order[j]].getID();
+			r1 = bodyRelation(preds, order[j], relations, deltas);
+			findLiterals(r1, params1);
 		}
 		if (j + 1 < preds.size()) {
-			tuples1 = r1.getTuples();
-			vector<Parameter> params2 = preds[j + 1].getParams();
-			string predName2 = preds[j + 1].getID();
-			Relation r2 = relations.at(predName2);
+			vector<Parameter> params2 = preds[order[j + 1]].getParams();
+			string predName2 = preds[order[j + 1]].getID();
+			Relation r2 = bodyRelation(preds, order[j + 1], relations, deltas);
 				
-			findLiterals(r2, params2, pred1);
-			set<Tuple> tuples2 = r2.getTuples();
+			findLiterals(r2, params2);
 			params1 = combineSchemes(r1, r2, matches, schemes, newRelation);
 			//predName1 = createName(schemes);
-			interpJoin(matches, newRelation,tuples1, tuples2);
-			newRelation.setName(rulesList[i].getPred().getID());
+			probes += interpJoin(matches, newRelation, r1, r2);
+			newRelation.setName(pred1.getID());
 			schemeSize = schemes.size();
 			r1 = newRelation;
 
@@ -333,40 +773,145 @@ void Interpreter::evaluatePredicateJoins(int& i, int& schemeSize, vector<pair<in
 		}
 		matches.clear();
 	}
+	if (profiler) {
+		profiler->rule(i).joinProbes += probes;
+	}
+}
+
+bool Interpreter::repeatsParameter(vector<Predicate>& preds) {
+	for (size_t j = 0; j < preds.size(); ++j) {
+		set<string> vars;
+		vector<Parameter>& params = preds[j].getParams();
+		for (size_t k = 0; k < params.size(); ++k) {
+			if (!vars.insert(params[k].getValue()).second) {
+				return true;
+			}
+		}
+	}
+	return false;
 }
 
-void Interpreter::matchlessJoin(set<Tuple>& tuples1, set<Tuple>& tuples2, Relation& newRelation) {
+vector<int> Interpreter::planJoinOrder(vector<Predicate>& preds, map<string, Relation>& relations, map<int, Relation>& deltas) {
+	int predSize = preds.size();
+	vector<int> order;
+	if (repeatsParameter(preds)) {
+		for (int p = 0; p < predSize; ++p) {
+			order.push_back(p);
+		}
+		return order;
+	}
+	vector<double> sizes(predSize);
+	vector<map<string, double>> distinct(predSize);
+	for (int j = 0; j < predSize; ++j) {
+		Relation r = bodyRelation(preds, j, relations, deltas);
+		vector<Parameter>& params = preds[j].getParams();
+		double size = r.size();
+		int paramSize = params.size();
+		for (int k = 0; k < paramSize && k < r.getArity() && r.size() > 0; ++k) {
+			double values = max(1, r.distinctCount(k));
+			if (!params[k].getisID()) {
+				size /= values;
+			}
+			else if (distinct[j].count(params[k].getValue()) == 0 || values < distinct[j][params[k].getValue()]) {
+				distinct[j][params[k].getValue()] = values;
+			}
+		}
+		sizes[j] = size;
+	}
 
-	for (set<Tuple>::iterator it1 = tuples1.begin(); it1 != tuples1.end(); ++it1) {
-		Tuple t1 = *it1;
-		for (set<Tuple>::iterator it2 = tuples2.begin(); it2 != tuples2.end(); ++it2) {
-			Tuple t2 = *it2;
-			for (unsigned int j = 0; j < t2.size(); ++j) {
-				t1.push_back(t2[j]);
+	vector<bool> used(predSize, false);
+	map<string, double> bound;
+	double current = 0;
+	for (int step = 0; step < predSize; ++step) {
+		int best = -1;
+		bool bestConnected = false;
+		double bestSize = 0;
+		for (int j = 0; j < predSize; ++j) {
+			if (used[j]) {
+				continue;
+			}
+			bool connected = step == 0;
+			double estimate = step == 0 ? sizes[j] : current * sizes[j];
+			for (map<string, double>::iterator it = distinct[j].begin(); it != distinct[j].end() && step > 0; ++it) {
+				if (bound.count(it->first) > 0) {
+					connected = true;
+					estimate /= max(bound[it->first], it->second);
+				}
+			}
+			if (best == -1 || (connected && !bestConnected) || (connected == bestConnected && estimate < bestSize)) {
+				best = j;
+				bestConnected = connected;
+				bestSize = estimate;
+			}
+		}
+		used[best] = true;
+		order.push_back(best);
+		current = bestSize;
+		for (map<string, double>::iterator it = distinct[best].begin(); it != distinct[best].end(); ++it) {
+			if (bound.count(it->first) == 0 || it->second < bound[it->first]) {
+				bound[it->first] = it->second;
 			}
-			newRelation.setTuples(t1);
-			t1 = *it1;
 		}
 	}
+	return order;
 }
 
-void Interpreter::joinable(vector<pair<int, int>>& matches, Tuple& t1, Tuple& t2, Relation& newRelation,vector<bool>& match) {
-	bool join = true;
-	int matchSize = matches.size();
-	for (int i = 0; i < matchSize; ++i) {
-		pair<int, int> pair1 = matches[i];
-		match[pair1.second] = false;
-		if (t1[pair1.first] != t2[pair1.second]) {
-			join = false;
-			break;
+long Interpreter::matchlessJoin(Relation& r1, Relation& r2, Relation& newRelation) {
+	if (r1.size() == 0 || r2.size() == 0) {
+		return 0;
+	}
+	vector<bool> match(r2.getArity(), true);
+	parallelJoin(r1.size(), r1.getArity() + r2.getArity(), newRelation, [&](int first, int last, vector<int>& buffer) {
+		Tuple t1;
+		Tuple t2;
+		for (int row1 = first; row1 < last; ++row1) {
+			r1.readRow(row1, t1);
+			for (int row2 = 0; row2 < r2.size(); ++row2) {
+				r2.readRow(row2, t2);
+				joinTuples(t1, t2, buffer, match);
+			}
+		}
+	});
+	return (long)r1.size() * r2.size();
+}
+
+void Interpreter::parallelJoin(int rows, int arity, Relation& newRelation, const function<void(int, int, vector<int>&)>& join) {
+	int morsels = (rows + MORSEL_ROWS - 1) / MORSEL_ROWS;
+	vector<vector<int>> buffers(morsels);
+	function<void(int)> body = [&](int m) {
+		join(m * MORSEL_ROWS, min(rows, (m + 1) * MORSEL_ROWS), buffers[m]);
+	};
+	if (pool && morsels > 1) {
+		pool->parallelFor(morsels, body);
+	}
+	else {
+		for (int m = 0; m < morsels; ++m) {
+			body(m);
 		}
 	}
-	if (join) {
-		relationJoin(t1, t2, newRelation, match);
+	if (arity == 0) {
+		return;
+	}
+	Tuple t;
+	for (int m = 0; m < morsels; ++m) {
+		vector<int>& buffer = buffers[m];
+		for (size_t k = 0; k < buffer.size(); k += arity) {
+			t.assign(buffer.begin() + k, buffer.begin() + k + arity);
+			newRelation.setTuples(t);
+		}
+		vector<int>().swap(buffer);
 	}
 }
 
-void Interpreter::findLiterals(Relation& r, vector<Parameter>& params, Predicate& pred) {
+void Interpreter::joinTuples(Tuple& t1, Tuple& t2, vector<int>& buffer, vector<bool>& match) {
+	buffer.insert(buffer.end(), t1.begin(), t1.end());
+	for (size_t i = 0; i < t2.size(); ++i) {
+		if (match[i])
+		buffer.push_back(t2[i]);
+	}
+}
+
+void Interpreter::findLiterals(Relation& r, vector<Parameter>& params) {
 	Scheme scheme = r.getScheme();
 	if (scheme.size() == 0)
         return;
@@ -384,25 +929,124 @@ void Interpreter::findLiterals(Relation& r, vector<Parameter>& params, Predicate
 	
 }
 
-void Interpreter::iterateTuples(vector<pair<int, int>>&matches,Relation& newRelation, set<Tuple>& tuples1, set<Tuple>& tuples2) {
+long Interpreter::hashJoin(vector<pair<int, int>>&matches,Relation& newRelation, Relation& r1, Relation& r2) {
+	if (r1.size() == 0 || r2.size() == 0) {
+		return 0;
+	}
+	vector<bool> match(r2.getArity(), true);
+	vector<int> columns1;
+	vector<int> columns2;
+	int matchSize = matches.size();
+	for (int i = 0; i < matchSize; ++i) {
+		columns1.push_back(matches[i].first);
+		columns2.push_back(matches[i].second);
+		match[matches[i].second] = false;
+	}
+	bool buildLeft = r1.size() < r2.size() && !r2.hasIndex(columns2);
+	Relation& build = buildLeft ? r1 : r2;
+	Relation& probe = buildLeft ? r2 : r1;
+	vector<int>& buildColumns = buildLeft ? columns1 : columns2;
+	vector<int>& probeColumns = buildLeft ? columns2 : columns1;
+	int arity = r1.getArity() + count(match.begin(), match.end(), true);
+	const TupleIndex& index = build.indexOn(buildColumns);
+	parallelJoin(probe.size(), arity, newRelation, [&](int first, int last, vector<int>& buffer) {
+		Tuple probeTuple;
+		Tuple buildTuple;
+		Tuple key;
+		key.resize(matchSize);
+		vector<int> rows;
+		for (int row = first; row < last; ++row) {
+			probe.readRow(row, probeTuple);
+			for (int i = 0; i < matchSize; ++i) {
+				key[i] = probeTuple[probeColumns[i]];
+			}
+			build.lookup(index, key.data(), rows);
+			for (size_t i = 0; i < rows.size(); ++i) {
+				build.readRow(rows[i], buildTuple);
+				if (buildLeft)
+					joinTuples(buildTuple, probeTuple, buffer, match);
+				else
+					joinTuples(probeTuple, buildTuple, buffer, match);
+			}
+		}
+	});
+	return probe.size();
+}
+
+bool Interpreter::useMergeJoin(vector<pair<int, int>>& matches, Relation& r1, Relation& r2) {
+	vector<int> columns1;
+	vector<int> columns2;
+	for (size_t i = 0; i < matches.size(); ++i) {
+		columns1.push_back(matches[i].first);
+		columns2.push_back(matches[i].second);
+	}
+	if (r1.hasOrder(columns1) && r2.hasOrder(columns2)) {
+		return true;
+	}
+	return min(r1.size(), r2.size()) >= MERGE_JOIN_ROWS;
+}
+
+long Interpreter::sortMergeJoin(vector<pair<int, int>>& matches, Relation& newRelation, Relation& r1, Relation& r2) {
+	if (r1.size() == 0 || r2.size() == 0) {
+		return 0;
+	}
+	vector<bool> match(r2.getArity(), true);
+	vector<int> columns1;
+	vector<int> columns2;
+	int matchSize = matches.size();
+	for (int i = 0; i < matchSize; ++i) {
+		columns1.push_back(matches[i].first);
+		columns2.push_back(matches[i].second);
+		match[matches[i].second] = false;
+	}
+	const vector<int>& order1 = r1.sortedBy(columns1);
+	const vector<int>& order2 = r2.sortedBy(columns2);
 	Tuple t1;
 	Tuple t2;
-	vector<bool> match;	
-	set<Tuple>::iterator it = tuples2.begin();
-	if (it != tuples2.end()) {
-		Tuple t = *it;
-		int size = t.size();
-		for (int i = 0; i < size; ++i) {
-			match.push_back(true);
+	size_t i1 = 0;
+	size_t i2 = 0;
+	long probes = 0;
+	while (i1 < order1.size() && i2 < order2.size()) {
+		++probes;
+		int compare = 0;
+		for (int k = 0; k < matchSize && compare == 0; ++k) {
+			int v1 = r1.get(order1[i1], columns1[k]);
+			int v2 = r2.get(order2[i2], columns2[k]);
+			compare = v1 < v2 ? -1 : (v1 > v2 ? 1 : 0);
 		}
-	}
-		for (set<Tuple>::iterator it1 = tuples1.begin(); it1 != tuples1.end(); ++it1) {
-			t1 = *it1;
-			for (set<Tuple>::iterator it2 = tuples2.begin(); it2 != tuples2.end(); ++it2) {
-				t2 = *it2;
-				joinable(matches, t1, t2, newRelation, match);
+		if (compare < 0) {
+			++i1;
+		}
+		else if (compare > 0) {
+			++i2;
+		}
+		else {
+			size_t end2 = i2 + 1;
+			while (end2 < order2.size() && sameKey(r2, order2[i2], order2[end2], columns2)) {
+				++end2;
+			}
+			size_t start1 = i1;
+			while (i1 < order1.size() && sameKey(r1, order1[start1], order1[i1], columns1)) {
+				r1.readRow(order1[i1], t1);
+				for (size_t j = i2; j < end2; ++j) {
+					r2.readRow(order2[j], t2);
+					relationJoin(t1, t2, newRelation, match);
+				}
+				++i1;
 			}
+			i2 = end2;
+		}
+	}
+	return probes;
+}
+
+bool Interpreter::sameKey(Relation& r, int row1, int row2, vector<int>& columns) {
+	for (size_t i = 0; i < columns.size(); ++i) {
+		if (r.get(row1, columns[i]) != r.get(row2, columns[i])) {
+			return false;
 		}
+	}
+	return true;
 }
 
 void Interpreter::selectLiterals(Relation& r, vector<Parameter>& params, Predicate& pred) {
@@ -468,7 +1112,7 @@ void Interpreter::doSelect(Relation& r, vector<Parameter>& params, set<string>&
 		bool select = params[i].getisID();
 		string value = params[i].getValue();
 		if (!select) {
-			r.selectValue(i, value);
+			r.selectValue(i, params[i].getSymbol());
 		}
 		else {
             size_t varSize = varName.size();
@@ -541,21 +1185,23 @@ void Interpreter::handleDuplicateMatches(vector<string>&schemes,Relation& newRel
     }
 }
 
-void Interpreter::singleRun(int i) {
-	map<string, Relation> relations = database.getRelations();
-	Predicate pred1 = rulesList[i].getPred();
+Relation Interpreter::evaluateRule(int i, map<string, Relation>& relations, map<int, Relation>& deltas) {
+	return evaluateRule(rulesList[i], i, relations, deltas);
+}
+
+Relation Interpreter::evaluateRule(Rule& rule, int i, map<string, Relation>& relations, map<int, Relation>& deltas) {
+	Predicate pred1 = rule.getPred();
 	vector<Parameter> params = pred1.getParams();
-	vector<Predicate> preds = rulesList[i].getPreds();
+	vector<Predicate> preds = rule.getPreds();
 	vector<pair<int, int>> matches;
 	vector<string> varNames;
 	Relation newRelation;
 	vector<int> varPos;
 	int schemeSize = 0;
 	int predSize = preds.size();
-	output << rulesList[i].toString() << endl;
 
 	if (predSize == 1) {
-		onePredicate(varNames, preds, varPos, pred1, newRelation, relations);
+		onePredicate(varNames, preds, varPos, pred1, newRelation, relations, deltas);
 		newRelation.setName(pred1.getID());
 		if (newRelation.getTupleCount() != 0) {
 			newRelation.project(varPos);
@@ -563,195 +1209,212 @@ void Interpreter::singleRun(int i) {
 		}
 	}
 	else {
-		evaluatePredicateJoins(i, schemeSize, matches, newRelation, relations);
+		evaluatePredicateJoins(rule, i, schemeSize, matches, newRelation, relations, deltas);
 		setNewSchemes(params, varPos, newRelation);
 		newRelation.project(varPos);
 		findRenameSchemes(pred1, varNames);
 		newRelation.rename(varPos, varNames);
 	}
+	if (profiler) {
+		Profiler::RuleProfile& profile = profiler->rule(i);
+		++profile.evaluations;
+		for (int j = 0; j < predSize; ++j) {
+			profile.inputTuples += bodyRelation(preds, j, relations, deltas).size();
+		}
+		profile.outputTuples += newRelation.size();
+	}
+	return newRelation;
+}
+
+int Interpreter::addRuleFacts(Relation& newRelation, OutputWriter& log) {
+	if (outputLevel >= NO_DERIVATIONS) {
+		return unionFacts(newRelation);
+	}
 	Relation tempR = findNewFacts(newRelation, newRelation.getName());
 	Scheme newScheme = newRelation.getScheme();
 	for (unsigned int j = 0; j < newScheme.size(); ++j) {
 		tempR.setScheme(newScheme[j]);
 	}
 	tempR.setName(newRelation.getName());
-	unionFacts(newRelation, relations);
+	int added = unionFacts(newRelation);
 	if (tempR.getTupleCount() > 0) {
-		output << tempR.toString(false);
+		tempR.write(log, false);
 	}
+	return added;
 }
 
-void Interpreter::fixedPointRun(set<int>& dependencies) {
-	int tupleCount = -1;
-	while (tupleCount != database.getTupleCount())
-	{
-		tupleCount = database.getTupleCount();
-		for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-			int i = *it;
-		map<string, Relation> relations = database.getRelations();
-		Predicate pred1 = rulesList[i].getPred();
-		vector<Parameter> params = pred1.getParams();
-		vector<Predicate> preds = rulesList[i].getPreds();
-		vector<pair<int, int>> matches;
-		vector<string> varNames;
-		Relation newRelation;
-		vector<int> varPos;
-		int schemeSize = 0;
-		int predSize = preds.size();
-		output << rulesList[i].toString() << endl;
+void Interpreter::profileRule(int i, double seconds, int added) {
+	if (!profiler) {
+		return;
+	}
+	Profiler::RuleProfile& profile = profiler->rule(i);
+	++profile.iterations;
+	profile.newTuples += added;
+	profile.seconds += seconds;
+}
 
-		if (predSize == 1) {
-			onePredicate(varNames, preds, varPos, pred1, newRelation, relations);
-			newRelation.setName(pred1.getID());
-			if (newRelation.getTupleCount() != 0) {
-				newRelation.project(varPos);
-				newRelation.rename(varPos, varNames);
-			}
+void Interpreter::profileRelation(const string& name) {
+	if (!profiler) {
+		return;
+	}
+	Relation& r = database.getRelation(name);
+	profiler->sampleRelation(name, r.size(), r.memoryUsage());
+}
+
+void Interpreter::singleRun(int i, OutputWriter& log) {
+	map<string, Relation>& relations = database.getRelations();
+	map<int, Relation> deltas;
+	log << rulesList[i].toString() << endl;
+	chrono::steady_clock::time_point start = Profiler::now();
+	Relation newRelation = evaluateRule(i, relations, deltas);
+	int added = addRuleFacts(newRelation, log);
+	profileRule(i, Profiler::since(start), added);
+	profileRelation(rulesList[i].getPred().getID());
+}
+
+void Interpreter::fixedPointRun(vector<int>& rules, OutputWriter& log) {
+	int ruleCount = rules.size();
+	vector<vector<int>> seen(ruleCount);
+	int added = -1;
+	while (added != 0)
+	{
+		added = 0;
+		if (jacobi && pool && ruleCount > 1) {
+			added = jacobiRound(rules, seen, log);
 		}
 		else {
-			evaluatePredicateJoins(i, schemeSize, matches, newRelation, relations);
-			setNewSchemes(params, varPos, newRelation);
-			newRelation.project(varPos);
-			findRenameSchemes(pred1, varNames);
-			newRelation.rename(varPos, varNames);
-		}
-		Relation tempR = findNewFacts(newRelation, newRelation.getName());
-		Scheme newScheme = newRelation.getScheme();
-		for (unsigned int j = 0; j < newScheme.size(); ++j) {
-			tempR.setScheme(newScheme[j]);
+			for (int k = 0; k < ruleCount; ++k) {
+				log << rulesList[rules[k]].toString() << endl;
+				chrono::steady_clock::time_point start = Profiler::now();
+				Relation newRelation = deriveFacts(rules[k], seen[k]);
+				int ruleAdded = addRuleFacts(newRelation, log);
+				profileRule(rules[k], Profiler::since(start), ruleAdded);
+				added += ruleAdded;
+			}
 		}
-		tempR.setName(newRelation.getName());
-		unionFacts(newRelation, relations);
-		if (tempR.getTupleCount() > 0) {
-			output << tempR.toString(false);
+		for (int k = 0; k < ruleCount; ++k) {
+			profileRelation(rulesList[rules[k]].getPred().getID());
 		}
 	}
-		}
-	
 }
 
-vector<set<int>> Interpreter::createDependencyGraph() {
-	map<string, set<int>> ruleNumbers;
-	for (size_t i = 0; i < rulesList.size(); ++i) {
-		set<int> dependPositions;
-		Predicate leftPred = rulesList[i].getPred();
-		string predName = leftPred.getID();
-		if (ruleNumbers.count(predName) > 0) {
-			dependPositions = ruleNumbers.at(predName);
-			ruleNumbers.erase(predName);
-		}
-		dependPositions.insert(i);
-		pair<string, set<int>> ruleNumber = { predName, dependPositions };
-		ruleNumbers.insert(ruleNumber);
-	}
-	vector<set<int>> dependGraph;
-	for (size_t i = 0; i < rulesList.size(); ++i) {
-		vector<Predicate> rightPreds = rulesList[i].getPreds();
-		set<int> dependencies;
-		for (size_t j = 0; j < rightPreds.size(); ++j) {
-			Predicate predicate = rightPreds[j];
-			string ruleName = predicate.getID();
-			if (ruleNumbers.count(ruleName) > 0) {
-				dependencies.insert(ruleNumbers.at(ruleName).begin(), ruleNumbers.at(ruleName).end());
+Relation Interpreter::deriveFacts(int i, vector<int>& marks) {
+	map<string, Relation>& relations = database.getRelations();
+	vector<Predicate>& preds = rulesList[i].getPreds();
+	vector<int> sizes;
+	for (size_t j = 0; j < preds.size(); ++j) {
+		sizes.push_back(relations.at(preds[j].getID()).size());
+	}
+	Relation newRelation;
+	if (marks.empty()) {
+		map<int, Relation> deltas;
+		newRelation = evaluateRule(i, relations, deltas);
+	}
+	else {
+		for (size_t j = 0; j < preds.size(); ++j) {
+			if (sizes[j] == marks[j]) {
+				continue;
+			}
+			map<int, Relation> deltas;
+			deltas[j] = relations.at(preds[j].getID()).sliceFrom(marks[j]);
+			Relation derived = evaluateRule(i, relations, deltas);
+			if (newRelation.size() == 0) {
+				newRelation = derived;
+			}
+			else {
+				newRelation.addTuples(derived);
 			}
 		}
-		dependGraph.push_back(dependencies);
+		newRelation.setName(rulesList[i].getPred().getID());
 	}
-	return dependGraph;
+	marks = sizes;
+	return newRelation;
 }
 
-vector<set<int>> Interpreter::createReverseGraph(vector<set<int>>& dependGraph) {
-	vector<set<int>> reverseGraph;
-	for (size_t i = 0; i < dependGraph.size(); ++i) {
-		set<int> d;
-		reverseGraph.push_back(d);
+int Interpreter::jacobiRound(vector<int>& rules, vector<vector<int>>& seen, OutputWriter& log) {
+	int ruleCount = rules.size();
+	vector<Relation> derived(ruleCount);
+	vector<double> times(ruleCount, 0);
+	pool->parallelFor(ruleCount, [&](int k) {
+		chrono::steady_clock::time_point start = Profiler::now();
+		derived[k] = deriveFacts(rules[k], seen[k]);
+		times[k] = Profiler::since(start);
+	});
+	map<string, vector<int>> heads;
+	for (int k = 0; k < ruleCount; ++k) {
+		heads[rulesList[rules[k]].getPred().getID()].push_back(k);
 	}
-
-	for (size_t i = 0; i < dependGraph.size(); ++i) {
-		set<int> dependencies = dependGraph[i];
-		for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-			int position = *it;
-			reverseGraph[position].insert(i);
-		}
+	vector<vector<int>*> groups;
+	for (map<string, vector<int>>::iterator it = heads.begin(); it != heads.end(); ++it) {
+		groups.push_back(&it->second);
 	}
-	return reverseGraph;
-}
-
-vector<int> Interpreter::depthForest(vector<set<int>>& reverseGraph) {
-	set<int> visitHistory;
-	vector<int> postOrderStack;
-	int graphSize = reverseGraph.size();
-	for (int i = 0; i < graphSize; ++i) {
-		if (visitHistory.count(i) == 0) {
-			depthFirstSearch(visitHistory, i, reverseGraph, postOrderStack);
+	vector<string> logs(ruleCount);
+	vector<int> counts(ruleCount, 0);
+	pool->parallelFor(groups.size(), [&](int g) {
+		vector<int>& group = *groups[g];
+		for (size_t n = 0; n < group.size(); ++n) {
+			OutputWriter ruleLog;
+			chrono::steady_clock::time_point start = Profiler::now();
+			counts[group[n]] = addRuleFacts(derived[group[n]], ruleLog);
+			times[group[n]] += Profiler::since(start);
+			logs[group[n]] = ruleLog.str();
 		}
+	});
+	int added = 0;
+	for (int k = 0; k < ruleCount; ++k) {
+		log << rulesList[rules[k]].toString() << endl << logs[k];
+		profileRule(rules[k], times[k], counts[k]);
+		added += counts[k];
 	}
-	return postOrderStack;
+	return added;
 }
 
-void Interpreter::depthFirstSearch(set<int>& visitHistory, int& index, vector<set<int>>& reverseGraph, vector<int>& postOrderStack) {
-	visitHistory.insert(index);
-	set<int> dependencies = reverseGraph[index];
-	for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-		int position = *it;
-		if (visitHistory.count(position) == 0)
-			depthFirstSearch(visitHistory, position, reverseGraph, postOrderStack);
+Graph Interpreter::createDependencyGraph() {
+	map<string, vector<int>> ruleNumbers;
+	for (size_t i = 0; i < rulesList.size(); ++i) {
+		ruleNumbers[rulesList[i].getPred().getID()].push_back(i);
 	}
-	postOrderStack.insert(postOrderStack.begin(), index);
-}
-
-vector<set<int>> Interpreter::findStrongConnections(vector<int>& postOrderStack, vector<set<int>>& dependencyGraph) {
-	vector<set<int>> postOrder;
-	set<int> visitHistory;
-
-	for (size_t i = 0; i < postOrderStack.size(); ++i) {
-
-		set<int> strongConnection;
-		int rulePosition = postOrderStack[i];
-		if(visitHistory.count(rulePosition) == 0)
-			strongConnection.insert(rulePosition);
-		visitHistory.insert(rulePosition);
-		set<int> dependencies = dependencyGraph[rulePosition];
-
-		for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-
-			int ruleNumber = *it;
-			if (visitHistory.count(ruleNumber) == 0) {
-				strongConnection.insert(ruleNumber);
-				visitHistory.insert(ruleNumber);
+	vector<pair<int, int>> edges;
+	for (size_t i = 0; i < rulesList.size(); ++i) {
+		vector<Predicate>& rightPreds = rulesList[i].getPreds();
+		for (size_t j = 0; j < rightPreds.size(); ++j) {
+			map<string, vector<int>>::iterator it = ruleNumbers.find(rightPreds[j].getID());
+			if (it == ruleNumbers.end()) {
+				continue;
+			}
+			for (size_t k = 0; k < it->second.size(); ++k) {
+				edges.push_back({ (int)i, it->second[k] });
 			}
 		}
-		if(strongConnection.size() != 0)
-		postOrder.push_back(strongConnection);
 	}
-	return postOrder;
+	return Graph(rulesList.size(), edges);
 }
 
-void Interpreter::printGraphs(vector<set<int>>& dependGraph) {
-	for (size_t i = 0; i < dependGraph.size(); ++i) {
-		output << "  R" << to_string(i) << ":";
-		set<int> dependencies = dependGraph[i];
-		if (dependencies.size() > 0) {
-			for (set<int>::iterator it = dependencies.begin(); it != dependencies.end(); ++it) {
-				output << " R" << to_string(*it);
-			}
+void Interpreter::printGraphs(Graph& graph) {
+	for (int i = 0; i < graph.size(); ++i) {
+		output << "  R" << i << ":";
+		for (const int* it = graph.begin(i); it != graph.end(i); ++it) {
+			output << " R" << *it;
 		}
 		output << endl;
 	}
 	output << endl;
 }
 
-void Interpreter::printOther(vector<int>& postStack, vector<set<int>>& strongConnections) {
-	for (size_t i = 0; i < postStack.size(); ++i) {
-		output << "  R" << to_string(i) << ": " << to_string(postStack[postStack.size() - i - 1] + 1) << endl;
+void Interpreter::printOther(vector<int>& finished, vector<vector<int>>& strongConnections) {
+	vector<int> numbers(finished.size());
+	for (size_t i = 0; i < finished.size(); ++i) {
+		numbers[finished[i]] = i + 1;
+	}
+	for (size_t i = 0; i < numbers.size(); ++i) {
+		output << "  R" << (int)i << ": " << numbers[i] << endl;
 	}
 	output << endl;
 
 	output << "SCC Search Order" << endl;
 	for (size_t i = 0; i < strongConnections.size(); ++i) {
-		set<int> sc = strongConnections[i];
-		for (set<int>::iterator it = sc.begin(); it != sc.end(); ++it) {
-			output << "  R" << to_string(*it) << endl;
+		for (size_t k = 0; k < strongConnections[i].size(); ++k) {
+			output << "  R" << strongConnections[i][k] << endl;
 		}
 	}
 }
\ No newline at end of file
@@ -2,56 +2,108 @@
 #include "DatalogParser.h"
 #include "Database.h"
 #include "Relation.h"
-#include <fstream>
+#include "ThreadPool.h"
+#include "QueryCache.h"
+#include "Profiler.h"
+#include "OutputWriter.h"
+#include "Graph.h"
+#include "ChangeSet.h"
+#include <memory>
+#include <mutex>
+#include <functional>
 using namespace std;
 
 class Interpreter {
+public:
+	enum OutputLevel { FULL_OUTPUT, NO_GRAPHS, NO_DERIVATIONS, QUIET };
 private:
 	vector<Predicate> schemesList;
-	vector<Predicate> factsList;
+	map<string, Relation> facts;
+	int factCount;
+	bool incremental;
+	map<string, Relation> baseFacts;
 	vector<Rule> rulesList;
 	vector<Predicate> queriesList;
-	ofstream output;
+	OutputWriter output;
+	OutputLevel outputLevel;
 	Database database;
+	int threads;
+	bool jacobi;
+	unique_ptr<ThreadPool> pool;
+	QueryCache queryCache;
+	mutex queryLock;
+	Profiler* profiler;
+	static const int MERGE_JOIN_ROWS = 1 << 18;
+	static const int MORSEL_ROWS = 1024;
 public:
-	Interpreter(DatalogParser, string);
+	Interpreter(DatalogParser&, string);
+	void setThreads(int);
+	void setJacobi(bool);
+	void setProfiler(Profiler*);
+	void setOutputLevel(OutputLevel);
+	void setIncremental(bool);
+	bool loadSnapshot(string);
+	bool saveSnapshot(string);
+	bool importFacts(string, string);
+	ThreadPool& workers();
+	QueryCache& getQueryCache();
+	Database& getDatabase();
+	set<string> derivedNames();
 	void evaluateSchemes();
 	void evaluateFacts();
 	void evaluateRules();
 	void evaluateQueries();
-    void interpRename(bool&, vector<string>&, vector<int>&, Relation&);
-    void interpProject(bool&, vector<string>&, vector<int>&, Relation&);
-    void interpPrint(bool&, vector<string>&, Relation&, unsigned int&);
-	void interpJoin(vector<pair<int, int>>&, Relation&,  set<Tuple>&, set<Tuple>&);
+	bool canAnswer(Predicate&);
+	void answerQuery(Predicate&, OutputWriter&);
+	bool evaluateChanges(ChangeSet&);
+	bool applyChanges(ChangeSet&, OutputWriter&);
+	bool validChanges(map<string, Relation>&);
+	int retractFacts(map<string, Relation>&, map<string, Relation>&);
+	int overdelete(map<string, Relation>&);
+	int rederive(map<string, Relation>&);
+	Relation seededRule(int, Relation&);
+	bool changedSince(vector<Predicate>&, vector<int>&);
+	int propagate(map<string, int>&);
+    void interpRename(vector<string>&, const QueryCache::Result&, OutputWriter&);
+    void interpProject(bool&, vector<string>&, vector<int>&, Relation&, OutputWriter&);
+    void interpPrint(bool&, Relation&, Predicate&, OutputWriter&);
+	long interpJoin(vector<pair<int, int>>&, Relation&, Relation&, Relation&);
 	void relationJoin(Tuple&, Tuple&, Relation&, vector<bool>&);
 	vector<Parameter> combineSchemes(Relation&, Relation&, vector<pair<int, int>>&, vector<string>&, Relation&);
 	void setNewSchemes(vector<Parameter>&, vector<int>&, Relation&);
-	Relation unionFacts(Relation&, map<string, Relation>&);
-    Relation findNewFacts(Relation&, string);
-	string createName(vector<string>&);
-	void makeVarNames(Relation&, vector<string>&);
-	void onePredicate(vector<string>&, vector<Predicate>&, vector<int>&, Predicate&, Relation&, map<string, Relation>&);
-	void evaluatePredicateJoins(int&, int&, vector<pair<int, int>>&, Relation&, map<string, Relation>&);
-	void removeTempRelations();
-	void matchlessJoin(set<Tuple>&, set<Tuple>&,Relation&);
-	void joinable(vector<pair<int, int>>&, Tuple&, Tuple&, Relation&, vector<bool>&);
-	void findLiterals(Relation&, vector<Parameter>&, Predicate&);
-	void iterateTuples(vector<pair<int,int>>&, Relation&, set<Tuple>&, set<Tuple>&);
-    void iterateTuples2(vector<pair<int, int>>&,Relation&, set<Tuple>&, set<Tuple>&, map<string,Relation>&);
+	int unionFacts(Relation&);
+    Relation findNewFacts(Relation&, const string&);
+	Relation bodyRelation(vector<Predicate>&, int, map<string, Relation>&, map<int, Relation>&);
+	void onePredicate(vector<string>&, vector<Predicate>&, vector<int>&, Predicate&, Relation&, map<string, Relation>&, map<int, Relation>&);
+	void evaluatePredicateJoins(Rule&, int&, int&, vector<pair<int, int>>&, Relation&, map<string, Relation>&, map<int, Relation>&);
+	bool repeatsParameter(vector<Predicate>&);
+	vector<int> planJoinOrder(vector<Predicate>&, map<string, Relation>&, map<int, Relation>&);
+	long matchlessJoin(Relation&, Relation&, Relation&);
+	void parallelJoin(int, int, Relation&, const function<void(int, int, vector<int>&)>&);
+	void joinTuples(Tuple&, Tuple&, vector<int>&, vector<bool>&);
+	void findLiterals(Relation&, vector<Parameter>&);
+	long hashJoin(vector<pair<int,int>>&, Relation&, Relation&, Relation&);
+	bool useMergeJoin(vector<pair<int, int>>&, Relation&, Relation&);
+	long sortMergeJoin(vector<pair<int, int>>&, Relation&, Relation&, Relation&);
+	bool sameKey(Relation&, int, int, vector<int>&);
 	void selectLiterals(Relation&, vector<Parameter>&, Predicate&);
     void findRenameSchemes(Predicate&, vector<string>&);
 	void doSelect(Relation&, vector<Parameter>&, set<string>&, vector<int>&, map<string, int>&);
-	void findMatches(Relation&, Relation&, map<string, int>&);
     void noliterals(Predicate&, vector<int>&, vector<Parameter>&,vector<Parameter>&);
     void handleDuplicateMatches(vector<string>&,Relation&,vector<Parameter>&,vector<pair<int,int>>&);
-    vector<set<int>> createReverseGraph(vector<set<int>>&);
-	vector<set<int>> createDependencyGraph();
-	vector<int> depthForest(vector<set<int>>& reverseGraph);
-	void depthFirstSearch(set<int>&, int&, vector<set<int>>&, vector<int>&);
-	vector<set<int>> findStrongConnections(vector<int>&, vector<set<int>>&);
-	void singleRun(int);
-	void fixedPointRun(set<int>&);
-	void printGraphs(vector<set<int>>&);
-	void printOther(vector<int>&, vector<set<int>>&);
+	Graph createDependencyGraph();
+	Relation evaluateRule(int, map<string, Relation>&, map<int, Relation>&);
+	Relation evaluateRule(Rule&, int, map<string, Relation>&, map<int, Relation>&);
+	int addRuleFacts(Relation&, OutputWriter&);
+	void profileRule(int, double, int);
+	void profileRelation(const string&);
+	void singleRun(int, OutputWriter&);
+	void fixedPointRun(vector<int>&, OutputWriter&);
+	Relation deriveFacts(int, vector<int>&);
+	int jacobiRound(vector<int>&, vector<vector<int>>&, OutputWriter&);
+	vector<vector<int>> scheduleComponents(vector<vector<int>>&);
+	void evaluateComponent(vector<int>&, Graph&, OutputWriter&);
+	void printGraphs(Graph&);
+	void printOther(vector<int>&, vector<vector<int>>&);
 
 };
@@ -0,0 +1,130 @@
+#include "MappedFile.h"
+#include <fstream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {
+	mapping = 0;
+	length = 0;
+	mapped = false;
+#ifdef _WIN32
+	file = 0;
+	view = 0;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const string& fileName) {
+	close();
+	if (map(fileName)) {
+		return true;
+	}
+	return read(fileName);
+}
+
+#ifdef _WIN32
+bool MappedFile::map(const string& fileName) {
+	HANDLE handle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(handle);
+		return false;
+	}
+	HANDLE section = CreateFileMappingA(handle, 0, PAGE_READONLY, 0, 0, 0);
+	CloseHandle(handle);
+	if (section == 0) {
+		return false;
+	}
+	void* address = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+	if (address == 0) {
+		CloseHandle(section);
+		return false;
+	}
+	file = section;
+	view = address;
+	mapping = (const char*)address;
+	length = (size_t)fileSize.QuadPart;
+	mapped = true;
+	return true;
+}
+
+void MappedFile::close() {
+	if (mapped) {
+		UnmapViewOfFile(view);
+		CloseHandle(file);
+		file = 0;
+		view = 0;
+	}
+	mapping = 0;
+	length = 0;
+	mapped = false;
+	vector<char>().swap(buffer);
+}
+#else
+bool MappedFile::map(const string& fileName) {
+	int descriptor = ::open(fileName.c_str(), O_RDONLY);
+	if (descriptor < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode) || status.st_size == 0) {
+		::close(descriptor);
+		return false;
+	}
+	void* address = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor);
+	if (address == MAP_FAILED) {
+		return false;
+	}
+	madvise(address, status.st_size, MADV_SEQUENTIAL);
+	mapping = (const char*)address;
+	length = status.st_size;
+	mapped = true;
+	return true;
+}
+
+void MappedFile::close() {
+	if (mapped) {
+		munmap((void*)mapping, length);
+	}
+	mapping = 0;
+	length = 0;
+	mapped = false;
+	vector<char>().swap(buffer);
+}
+#endif
+
+bool MappedFile::read(const string& fileName) {
+	ifstream input(fileName, ios::binary);
+	if (!input) {
+		return false;
+	}
+	buffer.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+	mapping = buffer.data();
+	length = buffer.size();
+	return true;
+}
+
+const char* MappedFile::data() const {
+	return mapping;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
+
+bool MappedFile::isMapped() const {
+	return mapped;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+class MappedFile {
+
+	public:
+		MappedFile();
+		~MappedFile();
+		bool open(const string&);
+		void close();
+		const char* data() const;
+		size_t size() const;
+		bool isMapped() const;
+	private:
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+		bool map(const string&);
+		bool read(const string&);
+		const char* mapping;
+		size_t length;
+		bool mapped;
+		vector<char> buffer;
+#ifdef _WIN32
+		void* file;
+		void* view;
+#endif
+};
@@ -0,0 +1,108 @@
+#include "OutputWriter.h"
+#include <sstream>
+
+OutputWriter::OutputWriter() {
+	toFile = false;
+}
+
+OutputWriter::~OutputWriter() {
+	close();
+}
+
+bool OutputWriter::open(const string& fileName) {
+	close();
+	file.open(fileName);
+	toFile = file.is_open();
+	buffer.reserve(BUFFER_SIZE);
+	return toFile;
+}
+
+void OutputWriter::close() {
+	if (toFile) {
+		flush();
+		file.close();
+		toFile = false;
+	}
+}
+
+void OutputWriter::flush() {
+	if (toFile) {
+		file.write(buffer.data(), buffer.size());
+		file.flush();
+		buffer.clear();
+	}
+}
+
+void OutputWriter::write(const char* text, size_t length) {
+	if (toFile && buffer.size() + length > BUFFER_SIZE) {
+		file.write(buffer.data(), buffer.size());
+		buffer.clear();
+		if (length > BUFFER_SIZE) {
+			file.write(text, length);
+			return;
+		}
+	}
+	buffer.append(text, length);
+}
+
+void OutputWriter::append(const OutputWriter& other) {
+	write(other.buffer.data(), other.buffer.size());
+}
+
+const string& OutputWriter::str() const {
+	return buffer;
+}
+
+OutputWriter& OutputWriter::operator<<(const string& text) {
+	write(text.data(), text.size());
+	return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(const char* text) {
+	StringView view(text);
+	write(view.data(), view.size());
+	return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(StringView text) {
+	write(text.data(), text.size());
+	return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(char c) {
+	if (toFile && buffer.size() >= BUFFER_SIZE) {
+		file.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+	buffer.push_back(c);
+	return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(int value) {
+	char digits[16];
+	char* end = digits + sizeof(digits);
+	char* start = end;
+	unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+	do {
+		*--start = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude > 0);
+	if (value < 0) {
+		*--start = '-';
+	}
+	write(start, end - start);
+	return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(ostream& (*manipulator)(ostream&)) {
+	if (manipulator == static_cast<ostream& (*)(ostream&)>(endl)) {
+		return *this << '\n';
+	}
+	if (manipulator == static_cast<ostream& (*)(ostream&)>(std::flush)) {
+		flush();
+		return *this;
+	}
+	ostringstream text;
+	manipulator(text);
+	return *this << text.str();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "StringView.h"
+#include <string>
+#include <fstream>
+#include <ostream>
+using namespace std;
+
+class OutputWriter {
+
+	public:
+		OutputWriter();
+		~OutputWriter();
+		bool open(const string&);
+		void close();
+		void flush();
+		void write(const char*, size_t);
+		void append(const OutputWriter&);
+		const string& str() const;
+		OutputWriter& operator<<(const string&);
+		OutputWriter& operator<<(const char*);
+		OutputWriter& operator<<(StringView);
+		OutputWriter& operator<<(char);
+		OutputWriter& operator<<(int);
+		OutputWriter& operator<<(ostream& (*)(ostream&));
+	private:
+		OutputWriter(const OutputWriter&);
+		OutputWriter& operator=(const OutputWriter&);
+		string buffer;
+		ofstream file;
+		bool toFile;
+		static const size_t BUFFER_SIZE = 1 << 20;
+};
@@ -1,7 +1,9 @@
 #include "Parameter.h"
 using namespace std;
 
-Parameter::Parameter(){}
+Parameter::Parameter(){
+	symbol = -1;
+}
 
 void Parameter::setisID(bool ID) {
 	isID = ID;
@@ -11,6 +13,10 @@ void Parameter::setValue(string val) {
 	value = val;
 }
 
+void Parameter::setSymbol(int id) {
+	symbol = id;
+}
+
 string Parameter::toString() {
 	return value;
 }
@@ -21,4 +27,8 @@ string Parameter::getValue() {
 
 bool Parameter::getisID() {
 	return isID;
+}
+
+int Parameter::getSymbol() {
+	return symbol;
 }
\ No newline at end of file
@@ -7,11 +7,14 @@ class Parameter{
 	private:
 		string value;
 		bool isID;
+		int symbol;
 	public:
 		Parameter();
 		void setisID(bool);
 		void setValue(string);
+		void setSymbol(int);
 		string toString();
 		string getValue();
 		bool getisID();
+		int getSymbol();
 };
\ No newline at end of file
@@ -5,7 +5,7 @@ Predicate::Predicate() {}
 void Predicate::setID(string value) {
 	ID = value;
 }
-vector<Parameter> Predicate::getParams() {
+vector<Parameter>& Predicate::getParams() {
 	return params;
 }
 
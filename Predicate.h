@@ -13,7 +13,7 @@ class Predicate {
 		Predicate();
 		void setID(string);
 		void setParams(Parameter);
-		vector<Parameter> getParams();
+		vector<Parameter>& getParams();
 		string getID();
 		string toString();
 };
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "Profiler.h"
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+Profiler::RuleProfile::RuleProfile() {
+	component = -1;
+	evaluations = 0;
+	iterations = 0;
+	inputTuples = 0;
+	outputTuples = 0;
+	newTuples = 0;
+	joinProbes = 0;
+	seconds = 0;
+}
+
+Profiler::ComponentProfile::ComponentProfile() {
+	recursive = false;
+	seconds = 0;
+}
+
+chrono::steady_clock::time_point Profiler::now() {
+	return chrono::steady_clock::now();
+}
+
+double Profiler::since(chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(now() - start).count();
+}
+
+void Profiler::addPhase(const string& name, double seconds) {
+	phases.push_back({ name, seconds });
+}
+
+void Profiler::setRules(const vector<string>& texts) {
+	rules.assign(texts.size(), RuleProfile());
+	for (size_t i = 0; i < texts.size(); ++i) {
+		rules[i].rule = texts[i];
+	}
+}
+
+void Profiler::setComponents(int count) {
+	components.assign(count, ComponentProfile());
+}
+
+Profiler::RuleProfile& Profiler::rule(int i) {
+	return rules[i];
+}
+
+Profiler::ComponentProfile& Profiler::component(int i) {
+	return components[i];
+}
+
+void Profiler::sampleRelation(const string& name, long tuples, size_t bytes) {
+	lock_guard<mutex> guard(lock);
+	RelationProfile& profile = relations[name];
+	profile.tuples = tuples;
+	profile.peakBytes = max(profile.peakBytes, bytes);
+}
+
+string Profiler::quote(const string& text) {
+	string quoted = "\"";
+	for (size_t i = 0; i < text.size(); ++i) {
+		unsigned char c = text[i];
+		if (c == '"' || c == '\\') {
+			quoted += '\\';
+			quoted += c;
+		}
+		else if (c < 0x20) {
+			static const char hex[] = "0123456789abcdef";
+			quoted += "\\u00";
+			quoted += hex[c >> 4];
+			quoted += hex[c & 15];
+		}
+		else {
+			quoted += c;
+		}
+	}
+	return quoted + "\"";
+}
+
+void Profiler::write(ostream& out) {
+	lock_guard<mutex> guard(lock);
+	out << fixed << setprecision(6);
+	out << "{" << endl << "  \"phases\": {";
+	for (size_t i = 0; i < phases.size(); ++i) {
+		out << (i > 0 ? ", " : "") << quote(phases[i].first) << ": " << phases[i].second;
+	}
+	out << "}," << endl << "  \"sccs\": [";
+	for (size_t i = 0; i < components.size(); ++i) {
+		ComponentProfile& c = components[i];
+		long iterations = 0;
+		long newTuples = 0;
+		long probes = 0;
+		out << (i > 0 ? "," : "") << endl << "    {\"index\": " << i << ", \"rules\": [";
+		for (size_t k = 0; k < c.rules.size(); ++k) {
+			RuleProfile& r = rules[c.rules[k]];
+			iterations = max(iterations, r.iterations);
+			newTuples += r.newTuples;
+			probes += r.joinProbes;
+			out << (k > 0 ? ", " : "") << c.rules[k];
+		}
+		out << "], \"recursive\": " << (c.recursive ? "true" : "false") << ", \"iterations\": " << iterations
+			<< ", \"new_tuples\": " << newTuples << ", \"join_probes\": " << probes << ", \"seconds\": " << c.seconds << "}";
+	}
+	out << endl << "  ]," << endl << "  \"rules\": [";
+	for (size_t i = 0; i < rules.size(); ++i) {
+		RuleProfile& r = rules[i];
+		out << (i > 0 ? "," : "") << endl << "    {\"index\": " << i << ", \"rule\": " << quote(r.rule) << ", \"scc\": " << r.component
+			<< ", \"evaluations\": " << r.evaluations << ", \"iterations\": " << r.iterations << ", \"input_tuples\": " << r.inputTuples
+			<< ", \"output_tuples\": " << r.outputTuples << ", \"new_tuples\": " << r.newTuples << ", \"join_probes\": " << r.joinProbes
+			<< ", \"seconds\": " << r.seconds << "}";
+	}
+	out << endl << "  ]," << endl << "  \"relations\": [";
+	bool first = true;
+	for (map<string, RelationProfile>::iterator it = relations.begin(); it != relations.end(); ++it) {
+		out << (first ? "" : ",") << endl << "    {\"name\": " << quote(it->first) << ", \"tuples\": " << it->second.tuples
+			<< ", \"peak_bytes\": " << it->second.peakBytes << "}";
+		first = false;
+	}
+	out << endl << "  ]" << endl << "}" << endl;
+}
+
+bool Profiler::save(const string& fileName) {
+	ofstream out(fileName);
+	if (!out) {
+		return false;
+	}
+	write(out);
+	return out.good();
+}
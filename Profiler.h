@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+using namespace std;
+
+class Profiler {
+
+	public:
+		struct RuleProfile {
+			string rule;
+			int component;
+			long evaluations;
+			long iterations;
+			long inputTuples;
+			long outputTuples;
+			long newTuples;
+			long joinProbes;
+			double seconds;
+			RuleProfile();
+		};
+		struct ComponentProfile {
+			vector<int> rules;
+			bool recursive;
+			double seconds;
+			ComponentProfile();
+		};
+		struct RelationProfile {
+			long tuples;
+			size_t peakBytes;
+		};
+		static chrono::steady_clock::time_point now();
+		static double since(chrono::steady_clock::time_point);
+		void addPhase(const string&, double);
+		void setRules(const vector<string>&);
+		void setComponents(int);
+		RuleProfile& rule(int);
+		ComponentProfile& component(int);
+		void sampleRelation(const string&, long, size_t);
+		void write(ostream&);
+		bool save(const string&);
+	private:
+		static string quote(const string&);
+		vector<pair<string, double>> phases;
+		vector<RuleProfile> rules;
+		vector<ComponentProfile> components;
+		map<string, RelationProfile> relations;
+		mutex lock;
+};
@@ -0,0 +1,69 @@
+#include "QueryCache.h"
+
+QueryCache::QueryCache() {
+	budget = DEFAULT_BUDGET;
+	used = 0;
+	hits = 0;
+	misses = 0;
+}
+
+void QueryCache::setBudget(size_t budget) {
+	this->budget = budget;
+	while (used > budget && !entries.empty()) {
+		used -= entries.back().first.size() + entries.back().second.memoryUsage();
+		positions.erase(entries.back().first);
+		entries.pop_back();
+	}
+}
+
+const QueryCache::Result* QueryCache::find(const string& key) {
+	unordered_map<string, Entries::iterator>::iterator it = positions.find(key);
+	if (it == positions.end()) {
+		++misses;
+		return 0;
+	}
+	++hits;
+	entries.splice(entries.begin(), entries, it->second);
+	return &it->second->second;
+}
+
+void QueryCache::insert(const string& key, const Result& result) {
+	size_t size = key.size() + result.memoryUsage();
+	if (size > budget || positions.count(key) > 0) {
+		return;
+	}
+	while (used + size > budget && !entries.empty()) {
+		used -= entries.back().first.size() + entries.back().second.memoryUsage();
+		positions.erase(entries.back().first);
+		entries.pop_back();
+	}
+	entries.push_front({ key, result });
+	positions[key] = entries.begin();
+	used += size;
+}
+
+void QueryCache::clear() {
+	entries.clear();
+	positions.clear();
+	used = 0;
+}
+
+int QueryCache::getHits() {
+	return hits;
+}
+
+int QueryCache::getMisses() {
+	return misses;
+}
+
+size_t QueryCache::memoryUsage() {
+	return used;
+}
+
+size_t QueryCache::Result::memoryUsage() const {
+	size_t size = sizeof(Result) + text.capacity() + rows.capacity() * sizeof(int);
+	for (size_t i = 0; i < scheme.size(); ++i) {
+		size += sizeof(string) + scheme[i].capacity();
+	}
+	return size;
+}
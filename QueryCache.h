@@ -0,0 +1,37 @@
+#pragma once
+#include "Scheme.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+using namespace std;
+
+class QueryCache {
+
+	public:
+		struct Result {
+			string text;
+			bool found;
+			Scheme scheme;
+			int arity;
+			vector<int> rows;
+			size_t memoryUsage() const;
+		};
+		QueryCache();
+		void setBudget(size_t);
+		const Result* find(const string&);
+		void insert(const string&, const Result&);
+		void clear();
+		int getHits();
+		int getMisses();
+		size_t memoryUsage();
+	private:
+		typedef list<pair<string, Result>> Entries;
+		Entries entries;
+		unordered_map<string, Entries::iterator> positions;
+		size_t budget;
+		size_t used;
+		int hits;
+		int misses;
+		static const size_t DEFAULT_BUDGET = 64 << 20;
+};
@@ -0,0 +1,173 @@
+#include "QueryServer.h"
+#include "Scanner.h"
+#include "DatalogParser.h"
+#include "ChangeSet.h"
+#include <thread>
+#include <cctype>
+#include <cstring>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#endif
+
+QueryServer::QueryServer(Interpreter& interpreter) : interpreter(interpreter) {
+}
+
+void QueryServer::serve(istream& input, ostream& output) {
+	string line;
+	while (getline(input, line)) {
+		string response;
+		bool open = handle(line, response);
+		output << response << flush;
+		if (!open) {
+			break;
+		}
+	}
+}
+
+bool QueryServer::handle(StringView line, string& response) {
+	const char* position = line.data();
+	const char* end = position + line.size();
+	while (position < end && isspace((unsigned char)*position)) {
+		++position;
+	}
+	while (end > position && isspace((unsigned char)end[-1])) {
+		--end;
+	}
+	StringView text(position, end - position);
+	if (text.empty() || text[0] == '#') {
+		return true;
+	}
+	if (text == StringView("quit") || text == StringView("exit")) {
+		return false;
+	}
+	if (text[0] == '+' || text[0] == '-') {
+		update(text, response);
+	}
+	else {
+		answer(text, response);
+	}
+	return true;
+}
+
+void QueryServer::answer(StringView text, string& response) {
+	Predicate query;
+	bool parsed;
+	{
+		unique_lock<shared_timed_mutex> writer(lock);
+		Scanner scanner;
+		scanner.openText(text);
+		DatalogParser parser(scanner);
+		parsed = parser.parseQueryText(query);
+	}
+	shared_lock<shared_timed_mutex> reader(lock);
+	if (!parsed || !interpreter.canAnswer(query)) {
+		response += "Error: " + text.toString() + "\n\n";
+		return;
+	}
+	OutputWriter log;
+	interpreter.answerQuery(query, log);
+	response += log.str();
+}
+
+void QueryServer::update(StringView text, string& response) {
+	unique_lock<shared_timed_mutex> writer(lock);
+	ChangeSet changes;
+	OutputWriter log;
+	if (!changes.parseLine(text) || !interpreter.applyChanges(changes, log)) {
+		response += "Error: " + text.toString() + "\n\n";
+		return;
+	}
+	response += log.str();
+}
+
+#ifdef _WIN32
+bool QueryServer::listen(const string& path) {
+	return false;
+}
+
+void QueryServer::session(int client) {
+}
+
+bool QueryServer::send(int client, const string& text) {
+	return false;
+}
+#else
+bool QueryServer::listen(const string& path) {
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path)) {
+		return false;
+	}
+	memcpy(address.sun_path, path.c_str(), path.size());
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0) {
+		return false;
+	}
+	signal(SIGPIPE, SIG_IGN);
+	unlink(path.c_str());
+	if (bind(server, (sockaddr*)&address, sizeof(address)) < 0 || ::listen(server, SOMAXCONN) < 0) {
+		close(server);
+		return false;
+	}
+	while (true) {
+		int client = accept(server, 0, 0);
+		if (client < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		thread(&QueryServer::session, this, client).detach();
+	}
+	close(server);
+	return false;
+}
+
+void QueryServer::session(int client) {
+	string pending;
+	char chunk[4096];
+	bool open = true;
+	while (open) {
+		ssize_t count = read(client, chunk, sizeof(chunk));
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			break;
+		}
+		pending.append(chunk, count);
+		string response;
+		size_t start = 0;
+		size_t newline;
+		while (open && (newline = pending.find('\n', start)) != string::npos) {
+			open = handle(StringView(pending.data() + start, newline - start), response);
+			start = newline + 1;
+		}
+		pending.erase(0, start);
+		if (!send(client, response)) {
+			break;
+		}
+	}
+	close(client);
+}
+
+bool QueryServer::send(int client, const string& text) {
+	size_t sent = 0;
+	while (sent < text.size()) {
+		ssize_t count = write(client, text.data() + sent, text.size() - sent);
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			return false;
+		}
+		sent += count;
+	}
+	return true;
+}
+#endif
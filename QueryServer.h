@@ -0,0 +1,24 @@
+#pragma once
+#include "Interpreter.h"
+#include "StringView.h"
+#include <string>
+#include <istream>
+#include <ostream>
+#include <shared_mutex>
+using namespace std;
+
+class QueryServer {
+
+	public:
+		QueryServer(Interpreter&);
+		void serve(istream&, ostream&);
+		bool listen(const string&);
+		bool handle(StringView, string&);
+	private:
+		void answer(StringView, string&);
+		void update(StringView, string&);
+		void session(int);
+		bool send(int, const string&);
+		Interpreter& interpreter;
+		shared_timed_mutex lock;
+};
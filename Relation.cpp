@@ -1,7 +1,11 @@
 #include "Relation.h"
+#include "SymbolTable.h"
 #include <set>
+#include <algorithm>
+#include <unordered_set>
 
-Relation::Relation() {
+Relation::Relation() : contents(make_shared<Contents>()) {
+	layout = TupleStore::ROW;
 	tupleCount = 0;
 }
 
@@ -9,7 +13,7 @@ void Relation::setScheme(string& value) {
 	scheme.push_back(value);
 }
 
-Scheme Relation::getScheme() {
+const Scheme& Relation::getScheme() {
 	return scheme;
 }
 
@@ -17,43 +21,266 @@ void Relation::setName(string name) {
 	this->name = name;
 }
 
+Relation::Contents& Relation::edit() {
+	if (contents.use_count() > 1) {
+		shared_ptr<Contents> detached = make_shared<Contents>();
+		detached->store = contents->store;
+		detached->rowSet = contents->rowSet;
+		{
+			lock_guard<mutex> guard(contents->cacheLock);
+			detached->indexes = contents->indexes;
+			detached->orders = contents->orders;
+			detached->distinct = contents->distinct;
+			detached->statisticsRows = contents->statisticsRows;
+		}
+		contents = detached;
+	}
+	return *contents;
+}
+
+void Relation::setLayout(TupleStore::Layout layout) {
+	this->layout = layout;
+	if (contents->store.getLayout() != layout && contents->store.size() > 0) {
+		TupleStore& store = edit().store;
+		TupleStore old = store;
+		store.reset(old.getArity(), layout);
+		Tuple t;
+		for (int i = 0; i < old.size(); ++i) {
+			old.read(i, t);
+			store.append(t.data());
+		}
+	}
+}
+
+TupleStore::Layout Relation::getLayout() {
+	return layout;
+}
+
+void Relation::loadRows(const int* values, int rows, int arity) {
+	contents = make_shared<Contents>();
+	contents->store.assign(values, rows, arity, layout);
+	contents->rowSet.rebuild(contents->store);
+	tupleCount = rows * arity;
+}
+
+bool Relation::insertTuple(const Tuple& tuple) {
+	if (contents->store.size() == 0) {
+		if (contents.use_count() > 1) {
+			contents = make_shared<Contents>();
+		}
+		contents->store.reset(tuple.size(), layout);
+	}
+	unsigned int h = TupleHashSet::hash(tuple.data(), tuple.size());
+	if (contents->rowSet.find(contents->store, tuple.data(), h) != -1) {
+		return false;
+	}
+	Contents& c = edit();
+	int row = c.store.append(tuple.data());
+	c.rowSet.insert(row, h);
+	for (map<vector<int>, TupleIndex>::iterator it = c.indexes.begin(); it != c.indexes.end(); ++it) {
+		it->second.add(c.store, row);
+	}
+	return true;
+}
+
 void Relation::setTuples(Tuple& tuple) {
-	tuples.insert(tuple);
+	insertTuple(tuple);
 	tupleCount += tuple.size();
 }
 
+int Relation::addTuples(Relation& other) {
+	int added = 0;
+	Tuple t;
+	for (int row = 0; row < other.size(); ++row) {
+		other.readRow(row, t);
+		if (insertTuple(t)) {
+			++added;
+		}
+		tupleCount += t.size();
+	}
+	return added;
+}
+
+int Relation::removeTuples(Relation& other) {
+	vector<int> keep;
+	Tuple t;
+	for (int row = 0; row < size(); ++row) {
+		readRow(row, t);
+		if (!other.contains(t)) {
+			keep.push_back(row);
+		}
+	}
+	int removed = size() - keep.size();
+	if (removed > 0) {
+		retainRows(keep);
+	}
+	return removed;
+}
+
+void Relation::adoptTuples(Relation& other) {
+	if (size() > 0) {
+		addTuples(other);
+		return;
+	}
+	contents = other.contents;
+	tupleCount += other.tupleCount;
+	setLayout(layout);
+}
+
+Relation Relation::sliceFrom(int first) {
+	Relation slice;
+	slice.name = name;
+	slice.scheme = scheme;
+	slice.layout = layout;
+	Tuple t;
+	for (int row = first; row < contents->store.size(); ++row) {
+		contents->store.read(row, t);
+		slice.setTuples(t);
+	}
+	return slice;
+}
+
+void Relation::retainRows(vector<int>& keep) {
+	shared_ptr<Contents> kept = make_shared<Contents>();
+	kept->store.assignRows(contents->store, keep);
+	kept->rowSet.rebuild(kept->store);
+	contents = kept;
+}
+
+bool Relation::hasIndex(const vector<int>& columns) {
+	lock_guard<mutex> guard(contents->cacheLock);
+	return contents->indexes.count(columns) > 0;
+}
+
+const vector<int>* Relation::findOrder(const vector<int>& columns) {
+	map<vector<int>, vector<int>>::iterator it = contents->orders.lower_bound(columns);
+	if (it == contents->orders.end() || it->first.size() < columns.size() || !equal(columns.begin(), columns.end(), it->first.begin())) {
+		return 0;
+	}
+	TupleStore& store = contents->store;
+	vector<int>& sorted = it->second;
+	int first = sorted.size();
+	if (first < store.size()) {
+		sorted.resize(store.size());
+		for (int i = first; i < store.size(); ++i) {
+			sorted[i] = i;
+		}
+		ColumnLess less(&store, &it->first);
+		sort(sorted.begin() + first, sorted.end(), less);
+		inplace_merge(sorted.begin(), sorted.begin() + first, sorted.end(), less);
+	}
+	return &sorted;
+}
+
+bool Relation::hasOrder(const vector<int>& columns) {
+	lock_guard<mutex> guard(contents->cacheLock);
+	return findOrder(columns) != 0;
+}
+
+const vector<int>& Relation::sortedBy(const vector<int>& columns) {
+	lock_guard<mutex> guard(contents->cacheLock);
+	const vector<int>* order = findOrder(columns);
+	if (order) {
+		return *order;
+	}
+	TupleStore& store = contents->store;
+	vector<int>& sorted = contents->orders[columns];
+	sorted.resize(store.size());
+	for (int i = 0; i < store.size(); ++i) {
+		sorted[i] = i;
+	}
+	sort(sorted.begin(), sorted.end(), ColumnLess(&store, &columns));
+	return sorted;
+}
+
+const TupleIndex& Relation::indexOn(const vector<int>& columns) {
+	lock_guard<mutex> guard(contents->cacheLock);
+	map<vector<int>, TupleIndex>::iterator it = contents->indexes.find(columns);
+	if (it == contents->indexes.end()) {
+		it = contents->indexes.insert({ columns, TupleIndex(columns) }).first;
+		it->second.build(contents->store);
+	}
+	return it->second;
+}
+
+void Relation::lookup(const TupleIndex& index, const int* key, vector<int>& rows) {
+	index.lookup(contents->store, key, rows);
+}
+
+void Relation::lookup(const vector<int>& columns, const int* key, vector<int>& rows) {
+	lookup(indexOn(columns), key, rows);
+}
+
 bool Relation::selectVariables(int& pos1, int& pos2) {
 	matches = 0;
 	bool found = false;
-	for (set<Tuple>::iterator it = tuples.begin(); it != tuples.end();) {
-		Tuple t = *it;
-		if (t[pos1] != t[pos2]) {
-			it = tuples.erase(it);
-		}
-		else {
+	vector<int> keep;
+	TupleStore& store = contents->store;
+	for (int i = 0; i < store.size(); ++i) {
+		if (store.get(i, pos1) == store.get(i, pos2)) {
+			keep.push_back(i);
 			found = true;
 			++matches;
-			++it;
 		}
 	}
+	retainRows(keep);
 	return found;
 }
 
-bool Relation::selectValue(int& pos, string value) {
-	matches = 0;
-	bool found = false;
-	for (set<Tuple>::iterator it = tuples.begin(); it != tuples.end();) {
-		Tuple t = *it;
-		if (t[pos] != value) {
-			it = tuples.erase(it);
+bool Relation::selectValue(int& pos, int value) {
+	vector<int> keep;
+	TupleStore& store = contents->store;
+	if (store.size() >= INDEX_THRESHOLD) {
+		vector<int> columns(1, pos);
+		lookup(columns, &value, keep);
+		sort(keep.begin(), keep.end());
+	}
+	else {
+		for (int i = 0; i < store.size(); ++i) {
+			if (store.get(i, pos) == value) {
+				keep.push_back(i);
+			}
 		}
-		else {
-			found = true;
-			++matches;
-			++it;
+	}
+	matches = keep.size();
+	retainRows(keep);
+	return matches > 0;
+}
+
+bool Relation::selectWhere(const vector<int>& columns, const vector<int>& values, const vector<pair<int, int>>& equal) {
+	vector<int> keep;
+	TupleStore& store = contents->store;
+	if (store.size() > 0 && !columns.empty() && store.size() >= INDEX_THRESHOLD) {
+		vector<int> candidates;
+		lookup(columns, values.data(), candidates);
+		sort(candidates.begin(), candidates.end());
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			bool match = true;
+			for (size_t k = 0; k < equal.size() && match; ++k) {
+				match = store.get(candidates[i], equal[k].first) == store.get(candidates[i], equal[k].second);
+			}
+			if (match) {
+				keep.push_back(candidates[i]);
+			}
 		}
 	}
-	return found;
+	else {
+		for (int row = 0; row < store.size(); ++row) {
+			bool match = true;
+			for (size_t k = 0; k < columns.size() && match; ++k) {
+				match = store.get(row, columns[k]) == values[k];
+			}
+			for (size_t k = 0; k < equal.size() && match; ++k) {
+				match = store.get(row, equal[k].first) == store.get(row, equal[k].second);
+			}
+			if (match) {
+				keep.push_back(row);
+			}
+		}
+	}
+	matches = keep.size();
+	retainRows(keep);
+	return matches > 0;
 }
 
 void Relation::rename(vector<int>& positions, vector<string>& names) {
@@ -64,73 +291,181 @@ void Relation::rename(vector<int>& positions, vector<string>& names) {
 }
 
 void Relation::project(vector<int>& positions) {
-	set<Tuple> tempTuples;
+	shared_ptr<Contents> old = contents;
     map<string, int> varList;
     vector<string> tempSchemes;
-	for (set<Tuple>::iterator it = tuples.begin(); it != tuples.end();++it) {
-		Tuple projT;
+	contents = make_shared<Contents>();
+	Tuple projT;
+	for (int row = 0; row < old->store.size(); ++row) {
+		projT.clear();
         for (size_t i = 0; i < positions.size(); ++i) {
-			Tuple t = *it;
-            projT.push_back(t[positions[i]]);
+            projT.push_back(old->store.get(row, positions[i]));
             if(varList.count(scheme[positions[i]]) == 0) {
                 varList[scheme[positions[i]]] = positions[i];
                 tempSchemes.push_back(scheme[positions[i]]);
             }
         }
-		tempTuples.insert(projT);
+		insertTuple(projT);
 	}
-	tuples.clear();
-	tuples = tempTuples;
-	if(tuples.size() > 0)
+	if(contents->store.size() > 0)
 		scheme.clear();
     for (unsigned int i =0; i< tempSchemes.size(); ++i) {
         scheme.push_back(tempSchemes[i]);
 	}
 }
 
+bool Relation::ColumnLess::operator()(int row1, int row2) const {
+	for (size_t i = 0; i < columns->size(); ++i) {
+		int v1 = store->get(row1, (*columns)[i]);
+		int v2 = store->get(row2, (*columns)[i]);
+		if (v1 != v2) {
+			return v1 < v2;
+		}
+	}
+	return false;
+}
+
+bool Relation::SymbolLess::operator()(int row1, int row2) const {
+	for (int i = 0; i < store->getArity(); ++i) {
+		int v1 = store->get(row1, i);
+		int v2 = store->get(row2, i);
+		if (v1 != v2) {
+			return SymbolTable::less(v1, v2);
+		}
+	}
+	return false;
+}
+
 string Relation::toString(bool print) {
-	string output;
+	OutputWriter output;
+	write(output, print);
+	return output.str();
+}
+
+void Relation::write(OutputWriter& output, bool print) {
 	if (print) {
-		output = name + '\n';
+		output << name << '\n';
 	}
-	for (set<Tuple>::iterator it = tuples.begin(); it != tuples.end();) {
-		Tuple t = *it++;
-		output += "  ";
+	TupleStore& store = contents->store;
+	vector<int> sorted = sortedRows();
+	for (vector<int>::iterator it = sorted.begin(); it != sorted.end(); ++it) {
+		output << "  ";
         for (size_t j = 0; j < scheme.size(); ++j) {
-            output += scheme[j] + "=" + t[j];
+            output << scheme[j] << '=' << SymbolTable::lookup(store.get(*it, j));
             if(j < scheme.size() - 1){
-                output += " ";
+                output << ' ';
             }
 		}
-		output += '\n';
+		output << '\n';
+	}
+}
+
+vector<int> Relation::sortedRows() {
+	TupleStore& store = contents->store;
+	vector<int> sorted(store.size());
+	for (int i = 0; i < store.size(); ++i) {
+		sorted[i] = i;
 	}
-	return output;
+	sort(sorted.begin(), sorted.end(), SymbolLess(&store));
+	return sorted;
 }
 
 int Relation::getMatches() {
 	return matches;
 }
 
-set<Tuple> Relation::getTuples() {
-	return tuples;
+int Relation::size() {
+	return contents->store.size();
+}
+
+int Relation::getArity() {
+	return contents->store.getArity();
+}
+
+int Relation::get(int row, int column) {
+	return contents->store.get(row, column);
+}
+
+void Relation::readRow(int row, Tuple& tuple) {
+	contents->store.read(row, tuple);
+}
+
+int Relation::distinctCount(int column) {
+	lock_guard<mutex> guard(contents->cacheLock);
+	int rows = contents->store.size();
+	if (contents->statisticsRows < 0 || abs(rows - contents->statisticsRows) * 10 > contents->statisticsRows) {
+		computeStatistics();
+	}
+	if (column >= (int)contents->distinct.size()) {
+		return 0;
+	}
+	return contents->distinct[column];
+}
+
+void Relation::computeStatistics() {
+	Contents& c = *contents;
+	int rows = c.store.size();
+	c.distinct.assign(c.store.getArity(), 0);
+	for (int column = 0; column < c.store.getArity(); ++column) {
+		unordered_set<int> values;
+		for (int row = 0; row < rows; ++row) {
+			values.insert(c.store.get(row, column));
+		}
+		c.distinct[column] = values.size();
+	}
+	c.statisticsRows = rows;
+}
+
+bool Relation::contains(const Tuple& tuple) {
+	TupleStore& store = contents->store;
+	if ((int)tuple.size() != store.getArity() || store.size() == 0) {
+		return false;
+	}
+	return contents->rowSet.find(store, tuple.data(), TupleHashSet::hash(tuple.data(), tuple.size())) != -1;
+}
+
+bool Relation::sameTuples(Relation& other) {
+	if (size() != other.size()) {
+		return false;
+	}
+	Tuple t;
+	for (int i = 0; i < size(); ++i) {
+		readRow(i, t);
+		if (!other.contains(t)) {
+			return false;
+		}
+	}
+	return true;
 }
 
 void Relation::setMatches(int& matches) {
 	this->matches = matches;
 }
 
-string Relation::getName() {
+const string& Relation::getName() {
 	return name;
 }
 
 void Relation::clearTuples() {
-	tuples.clear();
+	contents = make_shared<Contents>();
 }
 
 int Relation::getTupleCount() {
 	return tupleCount;
 }
 
+size_t Relation::memoryUsage() {
+	lock_guard<mutex> guard(contents->cacheLock);
+	size_t bytes = contents->store.memoryUsage() + contents->rowSet.memoryUsage();
+	for (map<vector<int>, TupleIndex>::iterator it = contents->indexes.begin(); it != contents->indexes.end(); ++it) {
+		bytes += it->second.memoryUsage();
+	}
+	for (map<vector<int>, vector<int>>::iterator it = contents->orders.begin(); it != contents->orders.end(); ++it) {
+		bytes += it->second.capacity() * sizeof(int);
+	}
+	return bytes;
+}
+
 void Relation::clearSchemes() {
 	scheme.clear();
 }
@@ -1,35 +1,92 @@
 #pragma once
 #include "Tuple.h"
 #include "Scheme.h"
+#include "TupleStore.h"
+#include "TupleHashSet.h"
+#include "TupleIndex.h"
+#include "OutputWriter.h"
 #include <set>
 #include <map>
 #include <string>
+#include <memory>
+#include <mutex>
 
 class Relation {
 	private:
-		set<Tuple> tuples;
+		struct ColumnLess {
+			const TupleStore* store;
+			const vector<int>* columns;
+			ColumnLess(const TupleStore* store, const vector<int>* columns) : store(store), columns(columns) {}
+			bool operator()(int row1, int row2) const;
+		};
+		struct SymbolLess {
+			const TupleStore* store;
+			SymbolLess(const TupleStore* store) : store(store) {}
+			bool operator()(int row1, int row2) const;
+		};
+		struct Contents {
+			TupleStore store;
+			TupleHashSet rowSet;
+			map<vector<int>, TupleIndex> indexes;
+			map<vector<int>, vector<int>> orders;
+			vector<int> distinct;
+			int statisticsRows;
+			mutex cacheLock;
+			Contents() : statisticsRows(-1) {}
+		};
+		static const int INDEX_THRESHOLD = 32;
+		shared_ptr<Contents> contents;
+		TupleStore::Layout layout;
 		string name;
 		Scheme scheme;
 		int matches;
 		int tupleCount;
+		Contents& edit();
+		bool insertTuple(const Tuple&);
+		void retainRows(vector<int>&);
+		const vector<int>* findOrder(const vector<int>&);
+		void computeStatistics();
 
 	public:
-        bool selectValue(int& pos, string value);
+        bool selectValue(int& pos, int value);
 		bool selectVariables(int& pos1, int& pos2);
+		bool selectWhere(const vector<int>&, const vector<int>&, const vector<pair<int, int>>&);
 		void project(vector<int>&);
 		void rename(vector<int>&, vector<string>&);
-		Scheme getScheme();
+		const Scheme& getScheme();
 		void setScheme(string&);
         void setName(string);
 		void setTuples(Tuple&);
+		int addTuples(Relation&);
+		int removeTuples(Relation&);
+		void adoptTuples(Relation&);
+		Relation sliceFrom(int);
 		void setMatches(int&);
+		void setLayout(TupleStore::Layout);
+		TupleStore::Layout getLayout();
+		void loadRows(const int*, int, int);
 		string toString(bool print);
+		void write(OutputWriter&, bool print);
+		vector<int> sortedRows();
 		int getMatches();
-		string getName();
-		set<Tuple> getTuples();
+		const string& getName();
+		int size();
+		int getArity();
+		int get(int, int);
+		void readRow(int, Tuple&);
+		void lookup(const vector<int>&, const int*, vector<int>&);
+		void lookup(const TupleIndex&, const int*, vector<int>&);
+		const TupleIndex& indexOn(const vector<int>&);
+		bool hasIndex(const vector<int>&);
+		const vector<int>& sortedBy(const vector<int>&);
+		bool hasOrder(const vector<int>&);
+		int distinctCount(int);
+		bool contains(const Tuple&);
+		bool sameTuples(Relation&);
 		void clearTuples();
 		void clearSchemes();
 		int getTupleCount();
+		size_t memoryUsage();
 		Relation();
 		void modifyScheme(Scheme&);
 };
@@ -23,11 +23,11 @@ string Rule::toString(){
 	return rule;
 }
 
-vector<Predicate> Rule::getPreds() {
+vector<Predicate>& Rule::getPreds() {
 	return predicates;
 }
 
-Predicate Rule::getPred() {
+Predicate& Rule::getPred() {
 	return pred;
 }
 
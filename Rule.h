@@ -12,8 +12,8 @@ class Rule {
 		Rule();
 		void setPred(Predicate&);
 		void addPredicates(Predicate&);
-		Predicate getPred();
-		vector<Predicate> getPreds();
+		Predicate& getPred();
+		vector<Predicate>& getPreds();
 		string toString();
 		void popPred();
 };
\ No newline at end of file
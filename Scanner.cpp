@@ -1,146 +1,173 @@
 #include "Scanner.h"
+#include <cstring>
 
-Scanner::Scanner() {}
-
-vector<Token> Scanner::executeScan(string fileName) {
+Scanner::Scanner() {
+	classes = classTable();
     keywords = {"Schemes", "Rules", "Queries", "Facts"};
-    tokens = {};
+	position = 0;
+	end = 0;
+	currentLine = 1;
+	hasToken = false;
+}
+
+const unsigned char* Scanner::classTable() {
+	static const vector<unsigned char> table = [] {
+		vector<unsigned char> built(256, 0);
+		for (int c = 'a'; c <= 'z'; ++c) {
+			built[c] = IDENT_START | IDENT_PART;
+			built[c - 'a' + 'A'] = IDENT_START | IDENT_PART;
+		}
+		for (int c = '0'; c <= '9'; ++c) {
+			built[c] = IDENT_PART;
+		}
+		const char* blanks = " \t\r\v\f";
+		for (size_t i = 0; i < strlen(blanks); ++i) {
+			built[(unsigned char)blanks[i]] = BLANK;
+		}
+		return built;
+	}();
+	return table.data();
+}
+
+void Scanner::open(string fileName) {
     currentLine = 1;
     inputFile.open(fileName);
-    inputChar = inputFile.get();
-    while (int(inputChar) != -1) {
-        scanToken();
-    }
-    createToken("", Token::EoF);
-    inputFile.close();
-    return tokens;
+	position = inputFile.data();
+	end = position + inputFile.size();
 }
 
-int Scanner::getTokenSize() {
-	return tokens.size();
+void Scanner::openText(StringView text) {
+	currentLine = 1;
+	inputFile.close();
+	position = text.data();
+	end = position + text.size();
+}
+
+Token Scanner::next() {
+	hasToken = false;
+    while (!hasToken && position < end && (unsigned char)*position != 0xFF) {
+        scanToken();
+    }
+	if (!hasToken) {
+		createToken(StringView(), Token::EoF);
+	}
+	return token;
 }
 
 void Scanner::skipWhiteSpace() {
-    while (isspace(inputChar) && inputChar != '\n') {
-		inputChar = inputFile.get();
+    while (position < end && (classes[(unsigned char)*position] & BLANK)) {
+		++position;
 	}
 }
 
 void Scanner::skipComment() {
-	if (inputChar == '#') {
-		inputChar = inputFile.get();
-		while (inputChar != '\n') {
-            inputChar = inputFile.get();
-		}
-        currentLine++;
-		inputChar = inputFile.get();
+	const char* newline = (const char*)memchr(position, '\n', end - position);
+	if (newline == 0) {
+		position = end;
+		return;
 	}
+	currentLine++;
+	position = newline + 1;
 }
 
 void Scanner::scanToken() {
 	Token::tokenType type;
-	switch (inputChar) {
+	switch (*position) {
 		case ',':
 			type = Token::COMMA;
-			createToken(string(1,inputChar), type);
-			inputChar = inputFile.get();
+			createToken(StringView(position, 1), type);
+			++position;
 			break;
 		case '.':
 			type = Token::PERIOD;
-			createToken(string(1, inputChar), type);
-			inputChar = inputFile.get();
+			createToken(StringView(position, 1), type);
+			++position;
 			break;
 		case '?':
 			type = Token::Q_MARK;
-			createToken(string(1, inputChar), type);
-			inputChar = inputFile.get();
+			createToken(StringView(position, 1), type);
+			++position;
 			break;
 		case '(':
 			type = Token::LEFT_PAREN;
-			createToken(string(1, inputChar), type);
-			inputChar = inputFile.get();
+			createToken(StringView(position, 1), type);
+			++position;
 			break;
 		case ')':
 			type = Token::RIGHT_PAREN;
-			createToken(string(1, inputChar), type);
-			inputChar = inputFile.get();
+			createToken(StringView(position, 1), type);
+			++position;
 			break;
 		case ':':
-			if (inputFile.peek() == '-') {
+			if (position + 1 < end && position[1] == '-') {
 				type = Token::COLON_DASH;
-				inputChar = inputFile.get();
-				string colonDash = ":-";
-				createToken(colonDash, type);
-				inputChar = inputFile.get();
-				break;
+				createToken(StringView(position, 2), type);
+				position += 2;
 			}
 			else {
 				type = Token::COLON;
-				createToken(string(1, inputChar), type);
-				inputChar = inputFile.get();
-				break;
+				createToken(StringView(position, 1), type);
+				++position;
 			}
+			break;
 		case '\'':
 			scanStringToken();
-			if (inputChar != -1) {
-				inputChar = inputFile.get();
-			}
             break;
         case ' ':
-            skipWhiteSpace();
-            break;
         case '\t':
-            cout << inputChar << endl;
             skipWhiteSpace();
             break;
         case '\n':
             currentLine++;
-            inputChar = inputFile.get();
+            ++position;
             break;
         case '#':
             skipComment();
             break;
 		default :
-			if (isalpha(inputChar)) {
+			if (classes[(unsigned char)*position] & IDENT_START) {
 				scanIdentifier();
 			}
 			else {
-				createToken("", Token::ERROR);
-				inputChar = -1;
+				createToken(StringView(), Token::ERROR);
+				position = end;
 			}
 	}	
 }
 
 void Scanner::scanIdentifier() {
-	string value;
-	value.append(string(1,inputChar));
-	inputChar = inputFile.get();
-	while (isalnum(inputChar) || isalpha(inputChar)) {
-		value.append(string(1, inputChar));
-		inputChar = inputFile.get();
+	const char* start = position;
+	++position;
+	while (position < end && (classes[(unsigned char)*position] & IDENT_PART)) {
+		++position;
 	}
-	Token::tokenType type = checkKeyword(value);
-	createToken(value, type);
+	StringView value(start, position - start);
+	createToken(value, checkKeyword(value));
 }
 	
 void Scanner::scanStringToken() {
-	Token::tokenType type = Token::STRING;
-	string value = string(1,inputChar);
-	inputChar = inputFile.get();
-	while (inputChar != '\'') {
-		value.append(string(1, inputChar));
-		inputChar = inputFile.get();
-		if (inputChar == '\n') {
-			createToken("", Token::ERROR);
-			inputChar = -1;
-			return;
-		}
+	const char* start = position;
+	const char* current = position + 1;
+	if (current < end && *current != '\'') {
+		do {
+			++current;
+			if (current >= end || *current == '\n') {
+				createToken(StringView(), Token::ERROR);
+				position = end;
+				return;
+			}
+		} while (*current != '\'');
 	}
-	value.append("'");
-	createToken(value, type);
+	else if (current >= end) {
+		createToken(StringView(), Token::ERROR);
+		position = end;
+		return;
+	}
+	position = current + 1;
+	createToken(StringView(start, position - start), Token::STRING);
 }
 
-Token::tokenType Scanner::checkKeyword(string in) {
+Token::tokenType Scanner::checkKeyword(StringView in) {
 	Token::tokenType type = Token::ID;
     unsigned int i;
     for ( i = 0; i < keywords.size(); i++) {
@@ -165,11 +192,7 @@ Token::tokenType Scanner::checkKeyword(string in) {
 	return type;
 }
 
-void Scanner::setInputChar(char in) {
-	inputChar = in;
-}
-
-void Scanner::createToken(string value, Token::tokenType type) {
-	Token newToken = Token(currentLine, value, type);
-	tokens.push_back(newToken);
+void Scanner::createToken(StringView value, Token::tokenType type) {
+	token = Token(currentLine, value, type);
+	hasToken = true;
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include "Token.h"
+#include "StringView.h"
+#include "MappedFile.h"
 #include <vector>
 #include <fstream>
 #include <iostream>
@@ -12,17 +14,22 @@ public:
 	void skipComment();
 	void scanIdentifier();
 	void scanStringToken();
-	void createToken(string, Token::tokenType);
-	void setInputChar(char);
-	int getTokenSize();
-    vector<Token> executeScan(string);
-	Token::tokenType checkKeyword(string);
+	void createToken(StringView, Token::tokenType);
+	void open(string);
+	void openText(StringView);
+	Token next();
+	Token::tokenType checkKeyword(StringView);
 
 private: 
-	vector<Token> tokens;
-	vector<string> keywords;
-	ifstream inputFile;
-	char inputChar;
+	enum charClass { IDENT_START = 1, IDENT_PART = 2, BLANK = 4 };
+	static const unsigned char* classTable();
+	vector<StringView> keywords;
+	Token token;
+	bool hasToken;
+	MappedFile inputFile;
+	const unsigned char* classes;
+	const char* position;
+	const char* end;
 	int currentLine;
 	
 };
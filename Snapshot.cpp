@@ -0,0 +1,180 @@
+#include "Snapshot.h"
+#include "SymbolTable.h"
+#include "MappedFile.h"
+#include "Tuple.h"
+#include <map>
+#include <algorithm>
+
+bool Snapshot::save(Database& database, const string& fileName) {
+	ofstream output(fileName, ios::binary);
+	if (!output) {
+		return false;
+	}
+	map<string, Relation>& relations = database.getRelations();
+	writeWord(output, MAGIC);
+	writeWord(output, VERSION);
+	writeWord(output, ENDIAN_MARK);
+	writeWord(output, SymbolTable::size());
+	writeWord(output, relations.size());
+	for (int id = 0; id < SymbolTable::size(); ++id) {
+		writeText(output, SymbolTable::lookup(id));
+	}
+	Tuple t;
+	for (map<string, Relation>::iterator it = relations.begin(); it != relations.end(); ++it) {
+		Relation& relation = it->second;
+		const Scheme& scheme = relation.getScheme();
+		writeText(output, it->first);
+		writeText(output, relation.getName());
+		writeWord(output, scheme.size());
+		for (size_t i = 0; i < scheme.size(); ++i) {
+			writeText(output, scheme[i]);
+		}
+		writeWord(output, relation.size() > 0 ? relation.getArity() : 0);
+		writeWord(output, relation.size());
+		for (int row = 0; row < relation.size(); ++row) {
+			relation.readRow(row, t);
+			output.write((const char*)t.data(), t.size() * sizeof(int));
+		}
+	}
+	return output.good();
+}
+
+bool Snapshot::load(Database& database, const string& fileName) {
+	MappedFile input;
+	if (!input.open(fileName)) {
+		return false;
+	}
+	Reader reader(input.data(), input.data() + input.size());
+	if (reader.word() != MAGIC || reader.word() != VERSION || reader.word() != ENDIAN_MARK) {
+		return false;
+	}
+	unsigned int symbolCount = reader.word();
+	unsigned int relationCount = reader.word();
+	vector<StringView> texts;
+	for (unsigned int id = 0; id < symbolCount && !reader.failed; ++id) {
+		texts.push_back(reader.text());
+	}
+	vector<Section> sections;
+	for (unsigned int r = 0; r < relationCount && !reader.failed; ++r) {
+		Section section;
+		section.key = reader.text().toString();
+		section.name = reader.text().toString();
+		unsigned int columns = reader.word();
+		for (unsigned int i = 0; i < columns && !reader.failed; ++i) {
+			section.scheme.push_back(reader.text().toString());
+		}
+		section.arity = reader.word();
+		section.rows = reader.word();
+		section.values = reader.values((size_t)section.arity * section.rows);
+		if (reader.failed || !matches(database, section, symbolCount)) {
+			return false;
+		}
+		sections.push_back(section);
+	}
+	if (reader.failed) {
+		return false;
+	}
+	vector<int> symbols;
+	bool identity = true;
+	string text;
+	for (unsigned int id = 0; id < symbolCount; ++id) {
+		text.assign(texts[id].data(), texts[id].size());
+		symbols.push_back(SymbolTable::intern(text));
+		identity = identity && symbols.back() == (int)id;
+	}
+	map<string, Relation>& relations = database.getRelations();
+	vector<int> translated;
+	for (size_t r = 0; r < sections.size(); ++r) {
+		Section& section = sections[r];
+		Relation relation;
+		relation.setName(section.name);
+		relation.modifyScheme(section.scheme);
+		map<string, Relation>::iterator target = relations.find(section.key);
+		if (target != relations.end()) {
+			relation.setLayout(target->second.getLayout());
+		}
+		size_t count = (size_t)section.arity * section.rows;
+		const int* values = section.values;
+		if (!identity) {
+			translated.resize(count);
+			for (size_t i = 0; i < count; ++i) {
+				translated[i] = symbols[values[i]];
+			}
+			values = translated.data();
+		}
+		relation.loadRows(values, section.rows, section.arity);
+		if (target == relations.end()) {
+			Relation created;
+			created.setName(section.name);
+			created.modifyScheme(section.scheme);
+			pair<string, Relation> p = { section.key, created };
+			database.initializeRelations(p);
+		}
+		database.loadFacts(section.key, relation);
+	}
+	return true;
+}
+
+bool Snapshot::matches(Database& database, const Section& section, unsigned int symbolCount) {
+	if (section.rows > 0 && section.arity != section.scheme.size()) {
+		return false;
+	}
+	map<string, Relation>& relations = database.getRelations();
+	map<string, Relation>::iterator target = relations.find(section.key);
+	if (target != relations.end()) {
+		const Scheme& scheme = target->second.getScheme();
+		if (target->second.getName() != section.name || scheme.size() != section.scheme.size() || !equal(scheme.begin(), scheme.end(), section.scheme.begin())) {
+			return false;
+		}
+	}
+	size_t count = (size_t)section.arity * section.rows;
+	for (size_t i = 0; i < count; ++i) {
+		if (section.values[i] < 0 || section.values[i] >= (int)symbolCount) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void Snapshot::writeWord(ofstream& output, unsigned int value) {
+	output.write((const char*)&value, sizeof(value));
+}
+
+void Snapshot::writeText(ofstream& output, const string& value) {
+	writeWord(output, value.size());
+	output.write(value.data(), value.size());
+	static const char padding[4] = { 0, 0, 0, 0 };
+	output.write(padding, (4 - value.size() % 4) % 4);
+}
+
+unsigned int Snapshot::Reader::word() {
+	if (failed || end - position < (ptrdiff_t)sizeof(unsigned int)) {
+		failed = true;
+		return 0;
+	}
+	unsigned int value = *(const unsigned int*)position;
+	position += sizeof(unsigned int);
+	return value;
+}
+
+StringView Snapshot::Reader::text() {
+	size_t length = word();
+	size_t padded = length + (4 - length % 4) % 4;
+	if (failed || (size_t)(end - position) < padded) {
+		failed = true;
+		return StringView();
+	}
+	StringView value(position, length);
+	position += padded;
+	return value;
+}
+
+const int* Snapshot::Reader::values(size_t count) {
+	if (failed || (size_t)(end - position) / sizeof(int) < count) {
+		failed = true;
+		return 0;
+	}
+	const int* data = (const int*)position;
+	position += count * sizeof(int);
+	return data;
+}
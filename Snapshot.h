@@ -0,0 +1,39 @@
+#pragma once
+#include "Database.h"
+#include "Relation.h"
+#include "Scheme.h"
+#include <string>
+#include <vector>
+#include <fstream>
+using namespace std;
+
+class Snapshot {
+
+	public:
+		static bool save(Database&, const string&);
+		static bool load(Database&, const string&);
+	private:
+		struct Reader {
+			const char* position;
+			const char* end;
+			bool failed;
+			Reader(const char* position, const char* end) : position(position), end(end), failed(false) {}
+			unsigned int word();
+			StringView text();
+			const int* values(size_t);
+		};
+		struct Section {
+			string key;
+			string name;
+			Scheme scheme;
+			unsigned int arity;
+			unsigned int rows;
+			const int* values;
+		};
+		static bool matches(Database&, const Section&, unsigned int);
+		static void writeWord(ofstream&, unsigned int);
+		static void writeText(ofstream&, const string&);
+		static const unsigned int MAGIC = 0x50414e53;
+		static const unsigned int VERSION = 1;
+		static const unsigned int ENDIAN_MARK = 0x01020304;
+};
@@ -0,0 +1,44 @@
+#include "StringView.h"
+#include <cstring>
+#include <algorithm>
+
+StringView::StringView() : text(""), length(0) {}
+
+StringView::StringView(const char* text) : text(text), length(strlen(text)) {}
+
+StringView::StringView(const char* text, size_t length) : text(text), length(length) {}
+
+StringView::StringView(const string& value) : text(value.data()), length(value.size()) {}
+
+const char* StringView::data() const {
+	return text;
+}
+
+size_t StringView::size() const {
+	return length;
+}
+
+bool StringView::empty() const {
+	return length == 0;
+}
+
+char StringView::operator[](size_t i) const {
+	return text[i];
+}
+
+string StringView::toString() const {
+	return string(text, length);
+}
+
+bool StringView::operator==(const StringView& other) const {
+	return length == other.length && memcmp(text, other.text, length) == 0;
+}
+
+bool StringView::operator!=(const StringView& other) const {
+	return !(*this == other);
+}
+
+bool StringView::operator<(const StringView& other) const {
+	int compare = memcmp(text, other.text, min(length, other.length));
+	return compare < 0 || (compare == 0 && length < other.length);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <cstddef>
+using namespace std;
+
+class StringView {
+
+	public:
+		StringView();
+		StringView(const char*);
+		StringView(const char*, size_t);
+		StringView(const string&);
+		const char* data() const;
+		size_t size() const;
+		bool empty() const;
+		char operator[](size_t) const;
+		string toString() const;
+		bool operator==(const StringView&) const;
+		bool operator!=(const StringView&) const;
+		bool operator<(const StringView&) const;
+	private:
+		const char* text;
+		size_t length;
+};
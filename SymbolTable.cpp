@@ -0,0 +1,33 @@
+#include "SymbolTable.h"
+using namespace std;
+
+unordered_map<string, int> SymbolTable::ids;
+vector<const string*> SymbolTable::symbols;
+
+int SymbolTable::intern(const string& value) {
+	pair<unordered_map<string, int>::iterator, bool> result = ids.insert({ value, (int)symbols.size() });
+	if (result.second) {
+		symbols.push_back(&result.first->first);
+	}
+	return result.first->second;
+}
+
+int SymbolTable::find(const string& value) {
+	unordered_map<string, int>::iterator it = ids.find(value);
+	if (it == ids.end()) {
+		return -1;
+	}
+	return it->second;
+}
+
+const string& SymbolTable::lookup(int id) {
+	return *symbols[id];
+}
+
+int SymbolTable::size() {
+	return symbols.size();
+}
+
+bool SymbolTable::less(int id1, int id2) {
+	return id1 != id2 && *symbols[id1] < *symbols[id2];
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+class SymbolTable {
+
+	public:
+		static int intern(const string&);
+		static int find(const string&);
+		static const string& lookup(int);
+		static int size();
+		static bool less(int, int);
+	private:
+		static unordered_map<string, int> ids;
+		static vector<const string*> symbols;
+};
@@ -0,0 +1,96 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) {
+	active = 0;
+	stopping = false;
+	if (threads < 1) {
+		threads = 1;
+	}
+	for (int i = 0; i < threads; ++i) {
+		workers.push_back(thread(&ThreadPool::work, this));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+	ready.notify_all();
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+}
+
+void ThreadPool::submit(function<void()> task) {
+	{
+		unique_lock<mutex> guard(lock);
+		tasks.push(task);
+	}
+	ready.notify_one();
+}
+
+void ThreadPool::wait() {
+	unique_lock<mutex> guard(lock);
+	idle.wait(guard, [this] { return tasks.empty() && active == 0; });
+}
+
+void ThreadPool::parallelFor(int count, const function<void(int)>& body) {
+	shared_ptr<Batch> batch = make_shared<Batch>();
+	batch->body = &body;
+	batch->next = 0;
+	batch->count = count;
+	batch->done = 0;
+	int helpers = min(count, (int)workers.size()) - 1;
+	for (int i = 0; i < helpers; ++i) {
+		submit([batch] { drain(*batch); });
+	}
+	drain(*batch);
+	unique_lock<mutex> guard(batch->lock);
+	batch->finished.wait(guard, [&batch] { return batch->done == batch->count; });
+}
+
+void ThreadPool::drain(Batch& batch) {
+	int i;
+	while ((i = batch.next++) < batch.count) {
+		(*batch.body)(i);
+		unique_lock<mutex> guard(batch.lock);
+		if (++batch.done == batch.count) {
+			batch.finished.notify_all();
+		}
+	}
+}
+
+int ThreadPool::getThreads() {
+	return workers.size();
+}
+
+int ThreadPool::defaultThreads() {
+	int threads = thread::hardware_concurrency();
+	return threads > 0 ? threads : 1;
+}
+
+void ThreadPool::work() {
+	while (true) {
+		function<void()> task;
+		{
+			unique_lock<mutex> guard(lock);
+			ready.wait(guard, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) {
+				return;
+			}
+			task = tasks.front();
+			tasks.pop();
+			++active;
+		}
+		task();
+		{
+			unique_lock<mutex> guard(lock);
+			--active;
+			if (tasks.empty() && active == 0) {
+				idle.notify_all();
+			}
+		}
+	}
+}
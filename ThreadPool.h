@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+using namespace std;
+
+class ThreadPool {
+
+	public:
+		ThreadPool(int);
+		~ThreadPool();
+		void submit(function<void()>);
+		void wait();
+		void parallelFor(int, const function<void(int)>&);
+		int getThreads();
+		static int defaultThreads();
+	private:
+		struct Batch {
+			const function<void(int)>* body;
+			atomic<int> next;
+			int count;
+			int done;
+			mutex lock;
+			condition_variable finished;
+		};
+		static void drain(Batch&);
+		void work();
+		vector<thread> workers;
+		queue<function<void()>> tasks;
+		mutex lock;
+		condition_variable ready;
+		condition_variable idle;
+		int active;
+		bool stopping;
+};
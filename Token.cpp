@@ -2,19 +2,18 @@
 #include "Scanner.h"
 #include <string>
 
-Token::Token(int lineNum, string val, tokenType type) {
+const char* const Token::typeNames[] = { "COMMA", "PERIOD", "Q_MARK", "LEFT_PAREN", "RIGHT_PAREN", "COLON",
+	"COLON_DASH", "SCHEMES", "FACTS", "RULES", "QUERIES", "ID", "STRING", "EOF", "" };
+
+Token::Token() {
+	lineNumber = 0;
+	type = EoF;
+}
+
+Token::Token(int lineNum, StringView val, tokenType type) {
 	lineNumber = lineNum;
 	value = val;
 	this->type = type;
-	initializeMap();
-}
-
-void Token::initializeMap() {
-	vector<string> enums = { "COMMA", "PERIOD", "Q_MARK", "LEFT_PAREN", "RIGHT_PAREN", "COLON",
-		"COLON_DASH", "SCHEMES", "FACTS", "RULES", "QUERIES", "ID", "STRING", "EOF" };
-    for (unsigned int i = 0; i < enums.size(); i++) {
-		tokenTypes[i] = enums[i];
-	}
 }
 
 int Token::getLineNumber() {
@@ -22,6 +21,10 @@ int Token::getLineNumber() {
 }
 
 string Token::getValue() {
+	return value.toString();
+}
+
+StringView Token::getText() {
 	return value;
 }
 
@@ -30,6 +33,6 @@ Token::tokenType Token::getType() {
 }
 
 string Token::toString() {
-	string token = "(" + tokenTypes[type] + "," + "\"" + value + "\"" + "," + to_string(lineNumber) + ")";
+	string token = "(" + string(typeNames[type]) + "," + "\"" + value.toString() + "\"" + "," + to_string(lineNumber) + ")";
 	return token;
 }
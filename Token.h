@@ -2,6 +2,7 @@
 #include <iostream>
 #include <map>
 #include <list>
+#include "StringView.h"
 using namespace std;
 
 class Token {
@@ -10,20 +11,20 @@ public:
 	enum tokenType {COMMA, PERIOD, Q_MARK, LEFT_PAREN, RIGHT_PAREN, COLON,
 		COLON_DASH, SCHEMES, FACTS, RULES, QUERIES, ID, STRING, EoF, ERROR};
 	Token();
-	Token(int, string, tokenType);
+	Token(int, StringView, tokenType);
 	string toString();
 	string getValue();
+	StringView getText();
 	int getLineNumber();
 	tokenType getType();
 	void setLineNumber();
 	void setType();
 	void setValue();
-	void initializeMap();
 
 private:
-	string value;
+	static const char* const typeNames[];
+	StringView value;
 	int lineNumber;
 	tokenType type;
-	map<int, string> tokenTypes;
 	
 };
\ No newline at end of file
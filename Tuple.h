@@ -3,6 +3,6 @@
 #include<string>
 using namespace std;
 
-class Tuple: public vector<string> {
+class Tuple: public vector<int> {
 
 };
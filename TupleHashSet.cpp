@@ -0,0 +1,101 @@
+#include "TupleHashSet.h"
+using namespace std;
+
+TupleHashSet::TupleHashSet() {
+	count = 0;
+}
+
+unsigned int TupleHashSet::hash(const int* values, int arity) {
+	unsigned int h = 2166136261u;
+	for (int i = 0; i < arity; ++i) {
+		h = mix(h, values[i]);
+	}
+	return finish(h);
+}
+
+unsigned int TupleHashSet::mix(unsigned int h, int value) {
+	h ^= (unsigned int)value;
+	h *= 0x9E3779B1u;
+	return (h << 13) | (h >> 19);
+}
+
+unsigned int TupleHashSet::finish(unsigned int h) {
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35u;
+	h ^= h >> 16;
+	return h;
+}
+
+int TupleHashSet::find(const TupleStore& store, const int* values, unsigned int h) const {
+	if (slots.empty()) {
+		return -1;
+	}
+	size_t mask = slots.size() - 1;
+	for (size_t i = h & mask; slots[i] != -1; i = (i + 1) & mask) {
+		if (hashes[i] == h && store.equals(slots[i], values)) {
+			return slots[i];
+		}
+	}
+	return -1;
+}
+
+void TupleHashSet::insert(int row, unsigned int h) {
+	if ((count + 1) * 10 > (int)slots.size() * 7) {
+		grow();
+	}
+	size_t mask = slots.size() - 1;
+	size_t i = h & mask;
+	while (slots[i] != -1) {
+		i = (i + 1) & mask;
+	}
+	slots[i] = row;
+	hashes[i] = h;
+	++count;
+}
+
+void TupleHashSet::grow() {
+	vector<int> oldSlots;
+	vector<unsigned int> oldHashes;
+	oldSlots.swap(slots);
+	oldHashes.swap(hashes);
+	size_t capacity = oldSlots.empty() ? 16 : oldSlots.size() * 2;
+	slots.assign(capacity, -1);
+	hashes.assign(capacity, 0);
+	count = 0;
+	for (size_t i = 0; i < oldSlots.size(); ++i) {
+		if (oldSlots[i] != -1) {
+			insert(oldSlots[i], oldHashes[i]);
+		}
+	}
+}
+
+void TupleHashSet::rebuild(const TupleStore& store) {
+	clear();
+	size_t capacity = 16;
+	while (capacity * 7 < (size_t)store.size() * 10 + 10) {
+		capacity *= 2;
+	}
+	slots.assign(capacity, -1);
+	hashes.assign(capacity, 0);
+	Tuple t;
+	for (int i = 0; i < store.size(); ++i) {
+		store.read(i, t);
+		insert(i, hash(t.data(), t.size()));
+	}
+}
+
+void TupleHashSet::clear() {
+	slots.clear();
+	hashes.clear();
+	count = 0;
+}
+
+int TupleHashSet::size() const {
+	return count;
+}
+
+size_t TupleHashSet::memoryUsage() const {
+	return slots.capacity() * sizeof(int) + hashes.capacity() * sizeof(unsigned int);
+}
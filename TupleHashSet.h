@@ -0,0 +1,24 @@
+#pragma once
+#include "TupleStore.h"
+#include <vector>
+using namespace std;
+
+class TupleHashSet {
+
+	public:
+		TupleHashSet();
+		static unsigned int hash(const int*, int);
+		static unsigned int mix(unsigned int, int);
+		static unsigned int finish(unsigned int);
+		int find(const TupleStore&, const int*, unsigned int) const;
+		void insert(int, unsigned int);
+		void rebuild(const TupleStore&);
+		void clear();
+		int size() const;
+		size_t memoryUsage() const;
+	private:
+		void grow();
+		vector<int> slots;
+		vector<unsigned int> hashes;
+		int count;
+};
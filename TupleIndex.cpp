@@ -0,0 +1,74 @@
+#include "TupleIndex.h"
+#include "TupleHashSet.h"
+using namespace std;
+
+TupleIndex::TupleIndex() {}
+
+TupleIndex::TupleIndex(const vector<int>& columns) {
+	this->columns = columns;
+}
+
+const vector<int>& TupleIndex::getColumns() const {
+	return columns;
+}
+
+unsigned int TupleIndex::rowHash(const TupleStore& store, int row) const {
+	unsigned int h = 2166136261u;
+	for (size_t i = 0; i < columns.size(); ++i) {
+		h = TupleHashSet::mix(h, store.get(row, columns[i]));
+	}
+	return TupleHashSet::finish(h);
+}
+
+void TupleIndex::link(int row, unsigned int h) {
+	size_t slot = h & (heads.size() - 1);
+	next[row] = heads[slot];
+	heads[slot] = row;
+}
+
+void TupleIndex::build(const TupleStore& store) {
+	size_t capacity = 16;
+	while (capacity < (size_t)store.size()) {
+		capacity *= 2;
+	}
+	heads.assign(capacity, -1);
+	next.assign(store.size(), -1);
+	for (int row = 0; row < store.size(); ++row) {
+		link(row, rowHash(store, row));
+	}
+}
+
+void TupleIndex::add(const TupleStore& store, int row) {
+	next.push_back(-1);
+	if ((size_t)store.size() > heads.size()) {
+		heads.assign(heads.size() * 2, -1);
+		for (int i = 0; i < row; ++i) {
+			link(i, rowHash(store, i));
+		}
+	}
+	link(row, rowHash(store, row));
+}
+
+void TupleIndex::lookup(const TupleStore& store, const int* key, vector<int>& rows) const {
+	rows.clear();
+	if (heads.empty()) {
+		return;
+	}
+	unsigned int h = TupleHashSet::hash(key, columns.size());
+	for (int row = heads[h & (heads.size() - 1)]; row != -1; row = next[row]) {
+		bool equal = true;
+		for (size_t i = 0; i < columns.size(); ++i) {
+			if (store.get(row, columns[i]) != key[i]) {
+				equal = false;
+				break;
+			}
+		}
+		if (equal) {
+			rows.push_back(row);
+		}
+	}
+}
+
+size_t TupleIndex::memoryUsage() const {
+	return (heads.capacity() + next.capacity()) * sizeof(int);
+}
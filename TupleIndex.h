@@ -0,0 +1,22 @@
+#pragma once
+#include "TupleStore.h"
+#include <vector>
+using namespace std;
+
+class TupleIndex {
+
+	public:
+		TupleIndex();
+		TupleIndex(const vector<int>&);
+		const vector<int>& getColumns() const;
+		void build(const TupleStore&);
+		void add(const TupleStore&, int);
+		void lookup(const TupleStore&, const int*, vector<int>&) const;
+		size_t memoryUsage() const;
+	private:
+		unsigned int rowHash(const TupleStore&, int) const;
+		void link(int, unsigned int);
+		vector<int> columns;
+		vector<int> heads;
+		vector<int> next;
+};
@@ -0,0 +1,151 @@
+#include "TupleStore.h"
+#include <algorithm>
+using namespace std;
+
+TupleStore::TupleStore() {
+	tailCapacity = 0;
+	arity = 0;
+	rows = 0;
+	layout = ROW;
+}
+
+void TupleStore::reset(int arity, Layout layout) {
+	blocks.clear();
+	tailCapacity = 0;
+	rows = 0;
+	this->arity = arity;
+	this->layout = layout;
+}
+
+int TupleStore::getArity() const {
+	return arity;
+}
+
+TupleStore::Layout TupleStore::getLayout() const {
+	return layout;
+}
+
+int TupleStore::size() const {
+	return rows;
+}
+
+int TupleStore::capacity(int block) const {
+	if (block + 1 == (int)blocks.size()) {
+		return tailCapacity;
+	}
+	return BLOCK_ROWS;
+}
+
+int TupleStore::append(const int* values) {
+	if (arity == 0) {
+		return rows++;
+	}
+	int offset = rows % BLOCK_ROWS;
+	if (offset == 0) {
+		blocks.push_back(vector<int>());
+		tailCapacity = rows == 0 ? 16 : BLOCK_ROWS;
+		if (layout == COLUMN) {
+			blocks.back().resize(tailCapacity * arity);
+		}
+		else {
+			blocks.back().reserve(tailCapacity * arity);
+		}
+	}
+	vector<int>& block = blocks.back();
+	if (layout == ROW) {
+		block.insert(block.end(), values, values + arity);
+		return rows++;
+	}
+	if (offset == tailCapacity) {
+		vector<int> grown(tailCapacity * 2 * arity);
+		for (int i = 0; i < arity; ++i) {
+			for (int j = 0; j < tailCapacity; ++j) {
+				grown[i * tailCapacity * 2 + j] = block[i * tailCapacity + j];
+			}
+		}
+		block.swap(grown);
+		tailCapacity *= 2;
+	}
+	for (int i = 0; i < arity; ++i) {
+		block[i * tailCapacity + offset] = values[i];
+	}
+	return rows++;
+}
+
+int TupleStore::get(int row, int column) const {
+	int b = row / BLOCK_ROWS;
+	int offset = row % BLOCK_ROWS;
+	if (layout == ROW) {
+		return blocks[b][offset * arity + column];
+	}
+	return blocks[b][column * capacity(b) + offset];
+}
+
+void TupleStore::read(int row, Tuple& tuple) const {
+	tuple.resize(arity);
+	for (int i = 0; i < arity; ++i) {
+		tuple[i] = get(row, i);
+	}
+}
+
+bool TupleStore::equals(int row, const int* values) const {
+	for (int i = 0; i < arity; ++i) {
+		if (get(row, i) != values[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TupleStore::assignRows(const TupleStore& from, const vector<int>& selected) {
+	reset(from.arity, from.layout);
+	Tuple t;
+	for (size_t i = 0; i < selected.size(); ++i) {
+		from.read(selected[i], t);
+		append(t.data());
+	}
+}
+
+void TupleStore::assign(const int* values, int count, int arity, Layout layout) {
+	reset(arity, layout);
+	if (arity == 0) {
+		rows = count;
+		return;
+	}
+	for (int first = 0; first < count; first += BLOCK_ROWS) {
+		int length = min((int)BLOCK_ROWS, count - first);
+		const int* source = values + (size_t)first * arity;
+		blocks.push_back(vector<int>());
+		vector<int>& block = blocks.back();
+		tailCapacity = 16;
+		while (tailCapacity < length) {
+			tailCapacity *= 2;
+		}
+		if (layout == ROW) {
+			block.reserve(tailCapacity * arity);
+			block.assign(source, source + length * arity);
+			continue;
+		}
+		block.resize(tailCapacity * arity);
+		for (int row = 0; row < length; ++row) {
+			for (int i = 0; i < arity; ++i) {
+				block[i * tailCapacity + row] = source[row * arity + i];
+			}
+		}
+	}
+	rows = count;
+}
+
+void TupleStore::clear() {
+	blocks.clear();
+	tailCapacity = 0;
+	rows = 0;
+}
+
+size_t TupleStore::memoryUsage() const {
+	size_t total = 0;
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		total += blocks[i].capacity() * sizeof(int);
+	}
+	return total;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Tuple.h"
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+class TupleStore {
+
+	public:
+		enum Layout { ROW, COLUMN };
+		TupleStore();
+		void reset(int, Layout);
+		int getArity() const;
+		Layout getLayout() const;
+		int size() const;
+		int append(const int*);
+		int get(int, int) const;
+		void read(int, Tuple&) const;
+		bool equals(int, const int*) const;
+		void assignRows(const TupleStore&, const vector<int>&);
+		void assign(const int*, int, int, Layout);
+		void clear();
+		size_t memoryUsage() const;
+	private:
+		static const int BLOCK_ROWS = 4096;
+		int capacity(int) const;
+		vector<vector<int>> blocks;
+		int tailCapacity;
+		int arity;
+		int rows;
+		Layout layout;
+};
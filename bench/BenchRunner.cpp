@@ -0,0 +1,142 @@
+#include "Workloads.h"
+#include "../Scanner.h"
+#include "../DatalogParser.h"
+#include "../Interpreter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static long peakMemoryKB() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return (long)(counters.PeakWorkingSetSize / 1024);
+	}
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static long tupleCount(Database& database) {
+	long count = 0;
+	for (auto& relation : database.getRelations()) {
+		count += relation.second.size();
+	}
+	return count;
+}
+
+static int runWorkload(const string& name, int size, int threads) {
+	string programFile = "bench_" + name + ".txt";
+	string outputFile = "bench_" + name + ".out";
+	{
+		ofstream program(programFile);
+		if (!Workloads::generate(name, size, program)) {
+			cerr << "unknown workload " << name << endl;
+			return 1;
+		}
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	Scanner lexer;
+	lexer.open(programFile);
+	long tokens = 0;
+	while (lexer.next().getType() != Token::EoF) {
+		++tokens;
+	}
+	double scanTime = seconds(start);
+
+	start = chrono::steady_clock::now();
+	Scanner scan;
+	scan.open(programFile);
+	DatalogParser parser(scan);
+	parser.parseFile(outputFile);
+	Interpreter interpreter(parser, outputFile);
+	if (threads > 0) {
+		interpreter.setThreads(threads);
+	}
+	double parseTime = seconds(start);
+
+	start = chrono::steady_clock::now();
+	interpreter.evaluateSchemes();
+	interpreter.evaluateFacts();
+	double factTime = seconds(start);
+	long facts = tupleCount(interpreter.getDatabase());
+
+	start = chrono::steady_clock::now();
+	interpreter.evaluateRules();
+	double ruleTime = seconds(start);
+	long tuples = tupleCount(interpreter.getDatabase());
+
+	start = chrono::steady_clock::now();
+	interpreter.evaluateQueries();
+	double queryTime = seconds(start);
+
+	ostringstream json;
+	json << "{\"workload\":\"" << name << "\",\"size\":" << size << ",\"tokens\":" << tokens
+		<< ",\"scan_s\":" << scanTime << ",\"parse_s\":" << parseTime << ",\"facts_s\":" << factTime
+		<< ",\"rules_s\":" << ruleTime << ",\"queries_s\":" << queryTime
+		<< ",\"total_s\":" << scanTime + parseTime + factTime + ruleTime + queryTime
+		<< ",\"fact_tuples\":" << facts << ",\"total_tuples\":" << tuples
+		<< ",\"peak_rss_kb\":" << peakMemoryKB() << "}";
+	cout << json.str() << endl;
+	remove(programFile.c_str());
+	remove(outputFile.c_str());
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	int threads = 0;
+	vector<string> args;
+	for (int i = 1; i < argc; ++i) {
+		string option = argv[i];
+		if (option.compare(0, 10, "--threads=") == 0) {
+			threads = stoi(option.substr(10));
+		}
+		else {
+			args.push_back(option);
+		}
+	}
+	if (args.size() >= 3 && args[0] == "--generate") {
+		int size = args.size() > 3 ? stoi(args[3]) : Workloads::defaultSize(args[1]);
+		ofstream program(args[2]);
+		return Workloads::generate(args[1], size, program) ? 0 : 1;
+	}
+	if (!args.empty()) {
+		int size = args.size() > 1 ? stoi(args[1]) : Workloads::defaultSize(args[0]);
+		return runWorkload(args[0], size, threads);
+	}
+	int failures = 0;
+	vector<string> names = Workloads::names();
+	for (size_t i = 0; i < names.size(); ++i) {
+		string command = string("\"") + argv[0] + "\" " + names[i];
+		if (threads > 0) {
+			command += " --threads=" + to_string(threads);
+		}
+		cout.flush();
+		if (system(command.c_str()) != 0) {
+			++failures;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}
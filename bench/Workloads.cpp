@@ -0,0 +1,166 @@
+#include "Workloads.h"
+#include <algorithm>
+
+vector<string> Workloads::names() {
+	return { "tc-chain", "tc-random", "same-generation", "points-to", "wide-join", "query-heavy" };
+}
+
+int Workloads::defaultSize(const string& name) {
+	if (name == "tc-chain") {
+		return 400;
+	}
+	if (name == "tc-random") {
+		return 600;
+	}
+	if (name == "same-generation") {
+		return 1000;
+	}
+	if (name == "points-to") {
+		return 1500;
+	}
+	if (name == "wide-join") {
+		return 20000;
+	}
+	if (name == "query-heavy") {
+		return 5000;
+	}
+	return 0;
+}
+
+bool Workloads::generate(const string& name, int size, ostream& out) {
+	if (name == "tc-chain") {
+		transitiveClosure(out, size, true);
+	}
+	else if (name == "tc-random") {
+		transitiveClosure(out, size, false);
+	}
+	else if (name == "same-generation") {
+		sameGeneration(out, size);
+	}
+	else if (name == "points-to") {
+		pointsTo(out, size);
+	}
+	else if (name == "wide-join") {
+		wideJoin(out, size);
+	}
+	else if (name == "query-heavy") {
+		queryHeavy(out, size);
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+string Workloads::node(int i) {
+	return "'n" + to_string(i) + "'";
+}
+
+void Workloads::transitiveClosure(ostream& out, int nodes, bool chain) {
+	mt19937 random(SEED);
+	uniform_int_distribution<int> pick(0, nodes - 1);
+	out << "Schemes:" << endl << "  edge(A,B)" << endl << "  path(A,B)" << endl;
+	out << "Facts:" << endl;
+	if (chain) {
+		for (int i = 0; i + 1 < nodes; ++i) {
+			out << "  edge(" << node(i) << "," << node(i + 1) << ")." << endl;
+		}
+	}
+	else {
+		for (int i = 0; i < nodes * 3 / 2; ++i) {
+			out << "  edge(" << node(pick(random)) << "," << node(pick(random)) << ")." << endl;
+		}
+	}
+	out << "Rules:" << endl;
+	out << "  path(x,y) :- edge(x,y)." << endl;
+	out << "  path(x,z) :- path(x,y),edge(y,z)." << endl;
+	out << "Queries:" << endl << "  path(" << node(0) << ",Y)?" << endl << "  path(X,Y)?" << endl;
+}
+
+void Workloads::sameGeneration(ostream& out, int nodes) {
+	mt19937 random(SEED);
+	out << "Schemes:" << endl << "  par(C,P)" << endl << "  sg(A,B)" << endl;
+	out << "Facts:" << endl;
+	for (int i = 1; i < nodes; ++i) {
+		uniform_int_distribution<int> parent(max(0, (i - 1) / 4 - 2), (i - 1) / 4);
+		out << "  par(" << node(i) << "," << node(parent(random)) << ")." << endl;
+	}
+	out << "Rules:" << endl;
+	out << "  sg(x,y) :- par(x,p),par(y,p)." << endl;
+	out << "  sg(x,y) :- par(x,a),sg(a,b),par(y,b)." << endl;
+	out << "Queries:" << endl << "  sg(" << node(nodes - 1) << ",Y)?" << endl;
+}
+
+void Workloads::pointsTo(ostream& out, int variables) {
+	mt19937 random(SEED);
+	uniform_int_distribution<int> pickVariable(0, variables - 1);
+	uniform_int_distribution<int> pickObject(0, variables / 10);
+	uniform_int_distribution<int> pickField(0, 3);
+	out << "Schemes:" << endl;
+	out << "  new(V,O)" << endl << "  assign(V,W)" << endl << "  load(V,W,F)" << endl << "  store(W,F,V)" << endl;
+	out << "  pt(V,O)" << endl << "  hpt(O,F,P)" << endl;
+	out << "Facts:" << endl;
+	for (int i = 0; i < variables / 5; ++i) {
+		out << "  new(" << node(pickVariable(random)) << ",'o" << pickObject(random) << "')." << endl;
+	}
+	for (int i = 0; i < variables; ++i) {
+		out << "  assign(" << node(pickVariable(random)) << "," << node(pickVariable(random)) << ")." << endl;
+	}
+	for (int i = 0; i < variables / 4; ++i) {
+		out << "  load(" << node(pickVariable(random)) << "," << node(pickVariable(random)) << ",'f" << pickField(random) << "')." << endl;
+		out << "  store(" << node(pickVariable(random)) << ",'f" << pickField(random) << "'," << node(pickVariable(random)) << ")." << endl;
+	}
+	out << "Rules:" << endl;
+	out << "  pt(v,o) :- new(v,o)." << endl;
+	out << "  pt(v,o) :- assign(v,w),pt(w,o)." << endl;
+	out << "  pt(v,o) :- load(v,w,f),pt(w,b),hpt(b,f,o)." << endl;
+	out << "  hpt(b,f,o) :- store(w,f,v),pt(w,b),pt(v,o)." << endl;
+	out << "Queries:" << endl << "  pt(" << node(0) << ",O)?" << endl << "  hpt(B,'f0',O)?" << endl;
+}
+
+void Workloads::wideJoin(ostream& out, int rows) {
+	mt19937 random(SEED);
+	uniform_int_distribution<int> pick(0, rows / 2);
+	const int width = 5;
+	out << "Schemes:" << endl;
+	for (int r = 0; r < width; ++r) {
+		out << "  r" << r << "(A,B)" << endl;
+	}
+	out << "  wide(A,B,C,D,E,F)" << endl;
+	out << "Facts:" << endl;
+	for (int r = 0; r < width; ++r) {
+		for (int i = 0; i < rows / width; ++i) {
+			out << "  r" << r << "(" << node(pick(random)) << "," << node(pick(random)) << ")." << endl;
+		}
+	}
+	out << "Rules:" << endl;
+	out << "  wide(a,b,c,d,e,f) :- r0(a,b),r1(b,c),r2(c,d),r3(d,e),r4(e,f)." << endl;
+	out << "Queries:" << endl << "  wide(A,B,C,D,E,F)?" << endl;
+}
+
+void Workloads::queryHeavy(ostream& out, int queries) {
+	mt19937 random(SEED);
+	int nodes = max(10, queries / 10);
+	uniform_int_distribution<int> pick(0, nodes - 1);
+	out << "Schemes:" << endl << "  edge(A,B)" << endl << "  path(A,B)" << endl;
+	out << "Facts:" << endl;
+	for (int i = 0; i < nodes * 2; ++i) {
+		out << "  edge(" << node(pick(random)) << "," << node(pick(random)) << ")." << endl;
+	}
+	out << "Rules:" << endl;
+	out << "  path(x,y) :- edge(x,y)." << endl;
+	out << "  path(x,z) :- edge(x,y),path(y,z)." << endl;
+	out << "Queries:" << endl;
+	for (int i = 0; i < queries; ++i) {
+		switch (i % 3) {
+			case 0:
+				out << "  path(" << node(pick(random)) << ",Y)?" << endl;
+				break;
+			case 1:
+				out << "  path(X," << node(pick(random)) << ")?" << endl;
+				break;
+			default:
+				out << "  path(" << node(pick(random)) << "," << node(pick(random)) << ")?" << endl;
+		}
+	}
+}
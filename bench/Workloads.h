@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+#include <random>
+using namespace std;
+
+class Workloads {
+
+	public:
+		static vector<string> names();
+		static int defaultSize(const string&);
+		static bool generate(const string&, int, ostream&);
+	private:
+		static void transitiveClosure(ostream&, int, bool);
+		static void sameGeneration(ostream&, int);
+		static void pointsTo(ostream&, int);
+		static void wideJoin(ostream&, int);
+		static void queryHeavy(ostream&, int);
+		static string node(int);
+		static const unsigned int SEED = 20160415;
+};
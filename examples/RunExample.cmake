@@ -0,0 +1,37 @@
+# Runs one example program with Project5 and compares what it writes
+# against the expected files checked in next to it.
+if(SETUP_PROGRAM)
+	execute_process(COMMAND ${DATALOG} ${SETUP_PROGRAM} ${OUTPUT}.setup ${SETUP_ARGS} RESULT_VARIABLE status)
+	if(NOT status EQUAL 0)
+		message(FATAL_ERROR "setup run of ${SETUP_PROGRAM} exited with ${status}")
+	endif()
+endif()
+set(input)
+if(INPUT)
+	set(input INPUT_FILE ${INPUT})
+endif()
+execute_process(COMMAND ${DATALOG} ${PROGRAM} ${OUTPUT} ${ARGS} ${input}
+	RESULT_VARIABLE status OUTPUT_FILE ${OUTPUT}.stdout ERROR_VARIABLE errors)
+if(FAILURE)
+	if(status EQUAL 0)
+		message(FATAL_ERROR "${PROGRAM} succeeded but was expected to fail")
+	endif()
+	string(FIND "${errors}" "${FAILURE}" found)
+	if(found EQUAL -1)
+		message(FATAL_ERROR "expected \"${FAILURE}\" on stderr, got \"${errors}\"")
+	endif()
+	return()
+endif()
+if(NOT status EQUAL 0)
+	message(FATAL_ERROR "${PROGRAM} exited with ${status}: ${errors}")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT} ${EXPECTED} RESULT_VARIABLE different)
+if(different)
+	message(FATAL_ERROR "${OUTPUT} differs from ${EXPECTED}")
+endif()
+if(STDOUT)
+	execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT}.stdout ${STDOUT} RESULT_VARIABLE different)
+	if(different)
+		message(FATAL_ERROR "${OUTPUT}.stdout differs from ${STDOUT}")
+	endif()
+endif()